@@ -0,0 +1,57 @@
+/**
+ * @brief checks that the children of a hidden container come back once the container is removed
+ *
+ * a clickable textbox is put into a container which is then hidden, which has to take it off the render list and out
+ * of hit testing. Removing the container leaves the textbox in no container at all, so it has to be drawn and
+ * clickable again.
+ */
+
+#include "../ui.hpp"
+
+#include <algorithm>
+#include <cstdio>
+
+static bool is_drawn(UI &ui, int element_id) {
+    const auto &render_list = ui.get_render_list();
+    return std::any_of(render_list.begin(), render_list.end(),
+                       [&](const UIDrawItem &item) { return item.id == element_id; });
+}
+
+int main() {
+    set_ui_log_level(UILogLevel::warn);
+
+    UniqueIDGenerator abs_pos_object_id_generator;
+    UI ui(0.5f, abs_pos_object_id_generator);
+
+    int container = ui.add_container(vertex_geometry::Rectangle(glm::vec3(0), 1, 1));
+    size_t clicks = 0;
+    vertex_geometry::Rectangle button_rect(glm::vec3(0), 0.4f, 0.2f);
+    int button = ui.add_clickable_textbox([&] { clicks++; }, [] {}, "button", button_rect, glm::vec3(0.2f),
+                                          glm::vec3(0.4f));
+    ui.add_to_container(container, button);
+    ui.update_layout();
+    const glm::vec2 button_center(ui.get_clickable_textbox(button)->rect.center);
+
+    size_t failures = 0;
+    auto check = [&](bool passed, const char *what) {
+        if (not passed) {
+            std::printf("%s\n", what);
+            failures++;
+        }
+    };
+
+    ui.set_hidden(container, true);
+    ui.process_mouse_just_clicked(button_center);
+    check(not ui.is_shown(button), "the button is shown while its container is hidden");
+    check(not is_drawn(ui, button), "the button is drawn while its container is hidden");
+    check(clicks == 0, "the button was clicked while its container is hidden");
+
+    ui.remove_container(container);
+    ui.process_mouse_just_clicked(button_center);
+    check(ui.is_shown(button), "the button isn't shown after its hidden container was removed");
+    check(is_drawn(ui, button), "the button isn't drawn after its hidden container was removed");
+    check(clicks == 1, "the button can't be clicked after its hidden container was removed");
+
+    std::printf(failures == 0 ? "container visibility test passed\n" : "container visibility test failed\n");
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,157 @@
+/**
+ * @brief checks that UIDirectoryListingCache lists directories, relists them when they change and evicts the least
+ * recently requested ones
+ *
+ * everything happens in a directory tree made under the system's temporary directory, which is removed at the end.
+ * Listing happens on background threads, so every check polls until the listing is complete or a few seconds passed.
+ */
+
+#include "../ui.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <string>
+#include <thread>
+
+namespace fs = std::filesystem;
+
+static bool poll_until(UIDirectoryListingCache &cache, const std::function<bool()> &done) {
+    auto give_up = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+    while (std::chrono::steady_clock::now() < give_up) {
+        cache.poll();
+        if (done())
+            return true;
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    return false;
+}
+
+static void create_file(const fs::path &path) { std::ofstream(path).put('\n'); }
+
+int main() {
+    auto now = std::chrono::steady_clock::now().time_since_epoch().count();
+    const fs::path root = fs::temp_directory_path() / ("ui_directory_listing_cache_test_" + std::to_string(now));
+    const fs::path big = root / "big", first = root / "first", second = root / "second", third = root / "third";
+    for (const fs::path &directory : {big, first, second, third})
+        fs::create_directories(directory);
+    // NOTE: more than one batch of the listing thread, so that the entries come in over several polls
+    const size_t file_count = 1000;
+    for (size_t i = 0; i < file_count; i++)
+        create_file(big / ("file " + std::to_string(i)));
+    fs::create_directory(big / "subdirectory");
+
+    size_t failures = 0;
+    auto check = [&](bool passed, const char *what) {
+        if (not passed) {
+            std::printf("%s\n", what);
+            failures++;
+        }
+    };
+
+    {
+        UIDirectoryListingCache cache;
+        check(not cache.request(big.string()).complete, "a directory was complete as soon as it was requested");
+        check(poll_until(cache, [&] { return cache.request(big.string()).complete; }), "listing never completed");
+
+        const auto &listing = cache.request(big.string());
+        check(listing.error.empty(), "listing reported an error");
+        check(listing.entries.size() == file_count + 1, "listing doesn't have every entry");
+        auto subdirectory = std::find_if(listing.entries.begin(), listing.entries.end(),
+                                         [](const UIDirectoryEntry &entry) { return entry.name == "subdirectory"; });
+        check(subdirectory != listing.entries.end() and subdirectory->is_directory,
+              "the subdirectory is missing or not a directory");
+        check(std::count_if(listing.entries.begin(), listing.entries.end(),
+                            [](const UIDirectoryEntry &entry) { return entry.is_directory; }) == 1,
+              "files were listed as directories");
+
+        const std::string missing = (root / "missing").string();
+        check(poll_until(cache, [&] { return cache.request(missing).complete; }),
+              "listing a missing directory never completed");
+        check(not cache.request(missing).error.empty(), "listing a missing directory didn't report an error");
+
+        uint64_t generation;
+#ifdef __linux__
+        generation = cache.request(big.string()).generation;
+        create_file(big / "new file");
+        check(poll_until(cache,
+                         [&] {
+                             const auto &relisted = cache.request(big.string());
+                             return relisted.complete and relisted.generation != generation;
+                         }),
+              "adding a file didn't relist the directory");
+        check(cache.request(big.string()).entries.size() == file_count + 2, "the relisting misses the new file");
+#endif
+
+        generation = cache.request(big.string()).generation;
+        size_t entry_count = cache.request(big.string()).entries.size();
+        cache.invalidate(big.string());
+        check(cache.request(big.string()).entries.size() == entry_count,
+              "invalidating dropped the entries before the new ones were complete");
+        check(poll_until(cache,
+                         [&] {
+                             const auto &relisted = cache.request(big.string());
+                             return relisted.complete and relisted.generation != generation;
+                         }),
+              "invalidating didn't relist the directory");
+    }
+
+    {
+        UIDirectoryListingCache cache(2);
+        cache.request(first.string());
+        cache.request(second.string());
+        auto both_complete = [&] {
+            return cache.request(first.string()).complete and cache.request(second.string()).complete;
+        };
+        check(poll_until(cache, both_complete), "listing the directories to evict never completed");
+
+        // NOTE: first was requested last, so third has to take the place of second
+        cache.request(first.string());
+        cache.request(third.string());
+        check(cache.size() == 2, "the cache holds more directories than its capacity");
+        check(cache.request(first.string()).complete, "the most recently requested directory was evicted");
+        check(not cache.request(second.string()).complete, "the least recently requested directory wasn't evicted");
+        check(cache.size() == 2, "requesting an evicted directory grew the cache past its capacity");
+    }
+
+#ifdef __linux__
+    {
+        // NOTE: both paths name the same directory so they share a watch, evicting one must not stop the other from
+        // being relisted
+        UIDirectoryListingCache cache(2);
+        const std::string path = first.string(), path_with_slash = first.string() + "/";
+        cache.request(path_with_slash);
+        cache.request(path);
+        check(poll_until(cache,
+                         [&] { return cache.request(path_with_slash).complete and cache.request(path).complete; }),
+              "listing a directory through two paths never completed");
+
+        // NOTE: path was requested last, so this evicts path_with_slash
+        cache.request(second.string());
+        check(cache.size() == 2, "the cache holds more directories than its capacity");
+        uint64_t generation = cache.request(path).generation;
+        create_file(first / "new file");
+        check(poll_until(cache,
+                         [&] {
+                             const auto &relisted = cache.request(path);
+                             return relisted.complete and relisted.generation != generation;
+                         }),
+              "evicting one path of a directory stopped the other from being relisted");
+    }
+#endif
+
+    {
+        // NOTE: dropping a cache in the middle of listing must neither wait for the listing nor crash when it finishes
+        UIDirectoryListingCache cache;
+        cache.request(big.string());
+    }
+
+    std::error_code error;
+    fs::remove_all(root, error);
+
+    std::printf(failures == 0 ? "directory listing cache test passed\n" : "directory listing cache test failed\n");
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,71 @@
+#ifndef HEAP_ALLOCATION_COUNTER_HPP
+#define HEAP_ALLOCATION_COUNTER_HPP
+
+#include <cstddef>
+#include <cstdlib>
+#include <new>
+
+/**
+ * @brief counts the heap allocations of the calling thread by replacing every form of the global operator new
+ *
+ * @note this replaces operators for the whole program, so it's only ever included by exactly one source file of a test
+ * or benchmark program and never by the library itself. The count is per thread so that allocations made by other
+ * threads (directory listings, parallel text generation) don't show up in what the thread running the ui measures.
+ *
+ * @note when the program is built with UI_COUNT_HEAP_ALLOCATIONS this also provides get_heap_allocation_count, which
+ * is what UI::heap_allocations_last_frame is measured with.
+ */
+inline thread_local size_t thread_heap_allocation_count = 0;
+
+#ifdef UI_COUNT_HEAP_ALLOCATIONS
+size_t get_heap_allocation_count() { return thread_heap_allocation_count; }
+#endif
+
+static void *allocate_counted(std::size_t size) {
+    thread_heap_allocation_count++;
+    return std::malloc(size == 0 ? 1 : size);
+}
+
+static void *allocate_counted(std::size_t size, std::align_val_t alignment) {
+    thread_heap_allocation_count++;
+    auto align = static_cast<std::size_t>(alignment);
+    // NOTE: aligned_alloc wants the size to be a multiple of the alignment
+    return std::aligned_alloc(align, (size + align - 1) / align * align + (size == 0 ? align : 0));
+}
+
+void *operator new(std::size_t size) {
+    if (void *p = allocate_counted(size))
+        return p;
+    throw std::bad_alloc();
+}
+void *operator new[](std::size_t size) { return operator new(size); }
+void *operator new(std::size_t size, const std::nothrow_t &) noexcept { return allocate_counted(size); }
+void *operator new[](std::size_t size, const std::nothrow_t &) noexcept { return allocate_counted(size); }
+
+void *operator new(std::size_t size, std::align_val_t alignment) {
+    if (void *p = allocate_counted(size, alignment))
+        return p;
+    throw std::bad_alloc();
+}
+void *operator new[](std::size_t size, std::align_val_t alignment) { return operator new(size, alignment); }
+void *operator new(std::size_t size, std::align_val_t alignment, const std::nothrow_t &) noexcept {
+    return allocate_counted(size, alignment);
+}
+void *operator new[](std::size_t size, std::align_val_t alignment, const std::nothrow_t &) noexcept {
+    return allocate_counted(size, alignment);
+}
+
+void operator delete(void *p) noexcept { std::free(p); }
+void operator delete[](void *p) noexcept { std::free(p); }
+void operator delete(void *p, std::size_t) noexcept { std::free(p); }
+void operator delete[](void *p, std::size_t) noexcept { std::free(p); }
+void operator delete(void *p, const std::nothrow_t &) noexcept { std::free(p); }
+void operator delete[](void *p, const std::nothrow_t &) noexcept { std::free(p); }
+void operator delete(void *p, std::align_val_t) noexcept { std::free(p); }
+void operator delete[](void *p, std::align_val_t) noexcept { std::free(p); }
+void operator delete(void *p, std::size_t, std::align_val_t) noexcept { std::free(p); }
+void operator delete[](void *p, std::size_t, std::align_val_t) noexcept { std::free(p); }
+void operator delete(void *p, std::align_val_t, const std::nothrow_t &) noexcept { std::free(p); }
+void operator delete[](void *p, std::align_val_t, const std::nothrow_t &) noexcept { std::free(p); }
+
+#endif // HEAP_ALLOCATION_COUNTER_HPP
@@ -0,0 +1,61 @@
+/**
+ * @brief checks that a render snapshot draws the text an element was given while it was hidden
+ *
+ * a textbox is hidden, has its text changed and then enough frames are published for every one of the three snapshots
+ * to have been filled without it. Once it's shown again the acquired snapshot has to hold the text geometry the ui has
+ * now rather than the geometry from before it was hidden.
+ */
+
+#include "../ui.hpp"
+
+#include <cstdio>
+#include <string>
+#include <vector>
+
+int main() {
+    set_ui_log_level(UILogLevel::warn);
+
+    UniqueIDGenerator abs_pos_object_id_generator;
+    UI ui(0.5f, abs_pos_object_id_generator);
+    ui.publish_render_snapshots = true;
+    NullUIRenderSuite render_suite;
+
+    int textbox = ui.add_textbox("before", vertex_geometry::Rectangle(glm::vec3(0), 0.8f, 0.2f), glm::vec3(0.2f));
+
+    const std::vector<std::string> no_keys;
+    const glm::vec2 nowhere(-0.9f, -0.9f);
+    auto run_frame = [&] { process_and_queue_render_ui(nowhere, ui, render_suite, no_keys, false, false, false); };
+
+    size_t failures = 0;
+    auto check = [&](bool passed, const char *what) {
+        if (not passed) {
+            std::printf("%s\n", what);
+            failures++;
+        }
+    };
+
+    run_frame();
+    ui.hide_textbox(textbox);
+    run_frame();
+    ui.modify_text_of_a_textbox(textbox, "after, and longer");
+    for (int i = 0; i < 5; i++)
+        run_frame();
+    ui.unhide_textbox(textbox);
+    run_frame();
+
+    const UIRenderSnapshot &snapshot = ui.acquire_render_snapshot();
+    const draw_info::IVPColor &live = ui.get_textbox(textbox)->text_drawing_ivpsc;
+    bool is_in_snapshot = false;
+    for (const auto &element : snapshot.get_elements()) {
+        if (element.item.id != textbox)
+            continue;
+        is_in_snapshot = true;
+        const draw_info::IVPColor &copy = snapshot.get_buffer(element.text_buffer_id);
+        check(copy.xyz_positions == live.xyz_positions and copy.indices == live.indices,
+              "the snapshot holds the text the textbox had before it was hidden");
+    }
+    check(is_in_snapshot, "the textbox isn't in the snapshot after it was shown again");
+
+    std::printf(failures == 0 ? "render snapshot test passed\n" : "render snapshot test failed\n");
+    return failures == 0 ? 0 : 1;
+}
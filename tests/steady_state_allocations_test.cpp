@@ -0,0 +1,112 @@
+/**
+ * @brief checks that once a ui has warmed up, a frame of process_and_queue_render_ui makes no heap allocations
+ *
+ * the same sequence of frames (hovering every kind of element, typing and deleting in an input box with and without
+ * wrapping, typing far past the edge of an input box a key per frame, opening a dropdown and picking an option,
+ * scrolling) is run twice, the first time lets every scratch buffer reach its size, the second time every frame has to
+ * allocate nothing.
+ *
+ * @note build ui.cpp and this with UI_COUNT_HEAP_ALLOCATIONS defined, otherwise nothing is counted and this fails.
+ */
+
+#include "../ui.hpp"
+#include "heap_allocation_counter.hpp"
+
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#ifndef UI_COUNT_HEAP_ALLOCATIONS
+#error "build this test and ui.cpp with UI_COUNT_HEAP_ALLOCATIONS defined"
+#endif
+
+struct Frame {
+    glm::vec2 mouse_position;
+    const std::vector<std::string> &keys;
+    bool delete_pressed = false;
+    bool clicked = false;
+    float scroll = 0;
+};
+
+int main() {
+    set_ui_log_level(UILogLevel::warn);
+
+    UniqueIDGenerator abs_pos_object_id_generator;
+    UI ui(0.5f, abs_pos_object_id_generator);
+    NullUIRenderSuite render_suite;
+
+    vertex_geometry::Rectangle button_rect(glm::vec3(-0.5f, 0.5f, 0), 0.4f, 0.1f);
+    vertex_geometry::Rectangle input_rect(glm::vec3(0.5f, 0.5f, 0), 0.4f, 0.1f);
+    // NOTE: two characters wide, so that the words typed into it end up on separate lines
+    vertex_geometry::Rectangle wrapped_input_rect(glm::vec3(0.5f, 0.1f, 0), 0.1f, 0.3f);
+    vertex_geometry::Rectangle dropdown_rect(glm::vec3(-0.5f, -0.2f, 0), 0.4f, 0.1f);
+    vertex_geometry::Rectangle list_rect(glm::vec3(0.5f, -0.5f, 0), 0.4f, 0.4f);
+
+    size_t clicks = 0;
+    ui.add_clickable_textbox([&] { clicks++; }, [] {}, "button", button_rect, glm::vec3(0.2f), glm::vec3(0.4f));
+    ui.add_input_box([](const std::string &) {}, "type here", input_rect, glm::vec3(0.2f), glm::vec3(0.4f));
+    int wrapped_input_box = ui.add_input_box([](const std::string &) {}, "type here", wrapped_input_rect,
+                                             glm::vec3(0.2f), glm::vec3(0.4f));
+    ui.set_text_wrap(wrapped_input_box, UITextWrap::words, 0.1f);
+    ui.add_dropdown([] {}, [] {}, 0, dropdown_rect, glm::vec3(0.2f), glm::vec3(0.4f), {"first", "second"},
+                    [](const std::string &) {}, [](const std::string &) {});
+    std::vector<std::string> items;
+    for (int i = 0; i < 100; i++)
+        items.push_back("item " + std::to_string(i));
+    ui.add_scroll_list([](size_t, const std::string &) {}, [](size_t, const std::string &) {}, list_rect, 0.1f,
+                       glm::vec3(0.2f), glm::vec3(0.4f), items);
+
+    const std::vector<std::string> no_keys, typed_keys{"a", "b"}, typed_words{"a", "b", " ", "c", "d"}, one_key{"x"};
+    const glm::vec2 button(-0.5f, 0.5f), input(0.5f, 0.5f), wrapped_input(0.5f, 0.1f), dropdown(-0.5f, -0.2f),
+        list(0.5f, -0.5f), first_option(-0.5f, -0.3f), nowhere(-0.9f, -0.9f);
+    std::vector<Frame> frames = {
+        {button, no_keys},
+        {button, no_keys, false, true},
+        {input, no_keys, false, true},
+        {input, typed_keys},
+        {input, no_keys, true},
+        {input, no_keys, true},
+        {wrapped_input, no_keys, false, true},
+        {wrapped_input, typed_words},
+        {wrapped_input, no_keys, true},
+        {wrapped_input, no_keys, true},
+        {wrapped_input, no_keys, true},
+        {wrapped_input, no_keys, true},
+        {wrapped_input, no_keys, true},
+        {dropdown, no_keys, false, true},
+        {first_option, no_keys},
+        {first_option, no_keys, false, true},
+        {list, no_keys, false, false, -1},
+        {list, no_keys, false, false, 1},
+        {nowhere, no_keys},
+        {input, no_keys, false, true},
+    };
+    // NOTE: the input box fits 8 characters, so a key per frame scrolls it several times both while typing and while
+    // deleting, clicking nowhere afterwards leaves the ui as it was at the start for the next pass
+    const size_t long_typed_count = 40;
+    for (size_t i = 0; i < long_typed_count; i++)
+        frames.push_back({input, one_key});
+    for (size_t i = 0; i < long_typed_count; i++)
+        frames.push_back({input, no_keys, true});
+    frames.push_back({nowhere, no_keys, false, true});
+
+    size_t failures = 0;
+    for (int pass = 0; pass < 2; pass++) {
+        for (size_t i = 0; i < frames.size(); i++) {
+            const Frame &frame = frames[i];
+            process_and_queue_render_ui(frame.mouse_position, ui, render_suite, frame.keys, frame.delete_pressed,
+                                        false, frame.clicked, frame.scroll);
+            if (pass == 1 and ui.heap_allocations_last_frame != 0) {
+                std::printf("frame %zu made %zu heap allocations\n", i, ui.heap_allocations_last_frame);
+                failures++;
+            }
+        }
+    }
+
+    if (clicks != 2) {
+        std::printf("the button was clicked %zu times instead of 2\n", clicks);
+        failures++;
+    }
+    std::printf(failures == 0 ? "steady state allocations test passed\n" : "steady state allocations test failed\n");
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,194 @@
+/**
+ * @brief times the hot paths of UI headless for growing element counts and reports the time and heap allocations of
+ * each operation
+ *
+ * every element count gets a fresh ui for each kind of element (rectangles, textboxes, clickable textboxes, input boxes
+ * and dropdowns) filled with that kind laid out in a grid covering the screen, then:
+ * - add: adding each of them
+ * - modify: changing the text of each of them, only for textboxes and clickable textboxes
+ * - process: a frame of process_and_queue_render_ui with the mouse moving over the elements
+ * - click: process_mouse_just_clicked on one of the elements
+ * - key: process_key_press typing into a focused input box, only for input boxes
+ * - delete: process_delete_action removing what was typed, only for input boxes
+ * - render: handing the render list to a NullUIRenderSuite
+ * - remove: removing each of them
+ *
+ * usage: ui_benchmark [largest element count] [log level], by default the counts go from 10 up to 100000 and the ui
+ * only logs warnings. The log level (debug, info, warn or off) is there to measure what logging costs, build with
+ * UI_COMPILED_LOG_LEVEL=0 so that every level is compiled in and compare info against off.
+ */
+
+#include "../ui.hpp"
+#include "heap_allocation_counter.hpp"
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <functional>
+#include <string>
+#include <vector>
+
+struct Measurement {
+    double seconds = 0;
+    size_t allocations = 0;
+};
+
+template <typename F> static Measurement measure(F &&run) {
+    size_t allocations_at_start = thread_heap_allocation_count;
+    auto start = std::chrono::steady_clock::now();
+    run();
+    auto end = std::chrono::steady_clock::now();
+    return {std::chrono::duration<double>(end - start).count(), thread_heap_allocation_count - allocations_at_start};
+}
+
+static void report(size_t element_count, const char *kind, const char *operation, size_t op_count,
+                   const Measurement &measurement) {
+    std::printf("%10zu  %-18s %-8s %12.1f %14.2f\n", element_count, kind, operation,
+                measurement.seconds * 1e9 / op_count, static_cast<double>(measurement.allocations) / op_count);
+}
+
+/**
+ * @brief how to add and remove one kind of element, has_text is for the kinds modify_text_of_a_textbox works on
+ */
+struct BenchmarkedKind {
+    const char *name;
+    std::function<int(UI &, size_t, const vertex_geometry::Rectangle &)> add;
+    std::function<bool(UI &, int)> remove;
+    bool has_text = false;
+    bool takes_key_presses = false;
+};
+
+static const std::vector<BenchmarkedKind> &get_benchmarked_kinds() {
+    static const std::vector<std::string> options = {"first", "second", "third"};
+    static const std::vector<BenchmarkedKind> kinds = {
+        {"rectangle",
+         [](UI &ui, size_t, const vertex_geometry::Rectangle &rect) {
+             return ui.add_colored_rectangle(rect, glm::vec3(0.2f));
+         },
+         [](UI &ui, int id) { return ui.remove_colored_rectangle(id); }},
+        {"textbox",
+         [](UI &ui, size_t i, const vertex_geometry::Rectangle &rect) {
+             return ui.add_textbox("item " + std::to_string(i), rect, glm::vec3(0.2f));
+         },
+         [](UI &ui, int id) { return ui.remove_textbox(id); }, true},
+        {"clickable_textbox",
+         [](UI &ui, size_t i, const vertex_geometry::Rectangle &rect) {
+             return ui.add_clickable_textbox([] {}, [] {}, "item " + std::to_string(i), rect, glm::vec3(0.2f),
+                                             glm::vec3(0.4f));
+         },
+         [](UI &ui, int id) { return ui.remove_clickable_textbox(id); }, true},
+        {"input_box",
+         [](UI &ui, size_t, const vertex_geometry::Rectangle &rect) {
+             return ui.add_input_box([](const std::string &) {}, "type here", rect, glm::vec3(0.2f),
+                                     glm::vec3(0.4f));
+         },
+         [](UI &ui, int id) { return ui.remove_input_box(id); }, false, true},
+        {"dropdown",
+         [](UI &ui, size_t, const vertex_geometry::Rectangle &rect) {
+             return ui.add_dropdown([] {}, [] {}, 0, rect, glm::vec3(0.2f), glm::vec3(0.4f), options,
+                                    [](const std::string &) {}, [](const std::string &) {});
+         },
+         [](UI &ui, int id) { return ui.remove_dropdown(id); }},
+    };
+    return kinds;
+}
+
+static void run_benchmark(const BenchmarkedKind &kind, size_t element_count, size_t frame_count) {
+    UniqueIDGenerator abs_pos_object_id_generator;
+    UI ui(0.5f, abs_pos_object_id_generator);
+    NullUIRenderSuite render_suite;
+
+    size_t columns = static_cast<size_t>(std::ceil(std::sqrt(static_cast<double>(element_count))));
+    float cell_size = 2.0f / columns;
+    auto cell_center = [&](size_t i) {
+        return glm::vec2(-1 + cell_size * (i % columns + 0.5f), 1 - cell_size * (i / columns + 0.5f));
+    };
+
+    std::vector<int> ids;
+    ids.reserve(element_count);
+    report(element_count, kind.name, "add", element_count, measure([&] {
+               for (size_t i = 0; i < element_count; i++) {
+                   glm::vec2 center = cell_center(i);
+                   vertex_geometry::Rectangle rect(glm::vec3(center, 0), cell_size * 0.9f, cell_size * 0.9f);
+                   ids.push_back(kind.add(ui, i, rect));
+               }
+           }));
+    // NOTE: the first frame uploads everything that was just added, that's part of adding rather than a frame
+    process_and_queue_render_ui(glm::vec2(2), ui, render_suite, {}, false, false, false);
+
+    if (kind.has_text) {
+        std::vector<std::string> new_texts(element_count);
+        for (size_t i = 0; i < element_count; i++)
+            new_texts[i] = "changed " + std::to_string(i);
+        report(element_count, kind.name, "modify", element_count, measure([&] {
+                   for (size_t i = 0; i < element_count; i++)
+                       ui.modify_text_of_a_textbox(ids[i], new_texts[i]);
+               }));
+        process_and_queue_render_ui(glm::vec2(2), ui, render_suite, {}, false, false, false);
+    }
+
+    const std::vector<std::string> no_keys;
+    report(element_count, kind.name, "process", frame_count, measure([&] {
+               for (size_t frame = 0; frame < frame_count; frame++) {
+                   glm::vec2 mouse_position = cell_center(frame * 7919 % element_count);
+                   process_and_queue_render_ui(mouse_position, ui, render_suite, no_keys, false, false, false);
+               }
+           }));
+
+    // NOTE: each click lands somewhere else, which also closes the dropdown the previous click opened
+    report(element_count, kind.name, "click", frame_count, measure([&] {
+               for (size_t frame = 0; frame < frame_count; frame++)
+                   ui.process_mouse_just_clicked(cell_center(frame * 7919 % element_count));
+           }));
+    process_and_queue_render_ui(glm::vec2(2), ui, render_suite, {}, false, false, false);
+
+    if (kind.takes_key_presses) {
+        ui.process_mouse_just_clicked(cell_center(0));
+        const std::string key = "a";
+        report(element_count, kind.name, "key", frame_count, measure([&] {
+                   for (size_t frame = 0; frame < frame_count; frame++)
+                       ui.process_key_press(key);
+               }));
+        report(element_count, kind.name, "delete", frame_count, measure([&] {
+                   for (size_t frame = 0; frame < frame_count; frame++)
+                       ui.process_delete_action();
+               }));
+        process_and_queue_render_ui(glm::vec2(2), ui, render_suite, {}, false, false, false);
+    }
+
+    const auto &render_list = ui.get_render_list();
+    report(element_count, kind.name, "render", frame_count, measure([&] {
+               for (size_t frame = 0; frame < frame_count; frame++)
+                   render_suite.render_ui(ui, render_list, true);
+           }));
+
+    report(element_count, kind.name, "remove", element_count, measure([&] {
+               for (int id : ids)
+                   kind.remove(ui, id);
+           }));
+}
+
+static UILogLevel parse_log_level(const char *name) {
+    const char *names[] = {"debug", "info", "warn", "off"};
+    for (int level = 0; level < 4; level++) {
+        if (std::strcmp(name, names[level]) == 0)
+            return static_cast<UILogLevel>(level);
+    }
+    std::fprintf(stderr, "unknown log level %s, using warn\n", name);
+    return UILogLevel::warn;
+}
+
+int main(int argc, char *argv[]) {
+    size_t largest_element_count = argc > 1 ? std::stoul(argv[1]) : 100000;
+    const size_t frame_count = 100;
+    // NOTE: warn by default so that the terminal isn't part of what gets measured
+    set_ui_log_level(argc > 2 ? parse_log_level(argv[2]) : UILogLevel::warn);
+
+    std::printf("%10s  %-18s %-8s %12s %14s\n", "elements", "kind", "op", "ns/op", "allocs/op");
+    for (size_t element_count = 10; element_count <= largest_element_count; element_count *= 10) {
+        for (const auto &kind : get_benchmarked_kinds())
+            run_benchmark(kind, element_count, frame_count);
+    }
+    return 0;
+}
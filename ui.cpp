@@ -1,800 +1,4193 @@
 #include "ui.hpp"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
 #include <glm/fwd.hpp>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <new>
+#include <numeric>
+#include <sstream>
+#include <thread>
+#include <tuple>
+#include <unordered_set>
+
+#ifdef __linux__
+#include <sys/inotify.h>
+#endif
+#if defined(__linux__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+static std::atomic<UILogLevel> ui_log_level{UILogLevel::info};
+
+void set_ui_log_level(UILogLevel level) { ui_log_level.store(level, std::memory_order_relaxed); }
+UILogLevel get_ui_log_level() { return ui_log_level.load(std::memory_order_relaxed); }
+
+static bool is_ui_log_level_enabled(UILogLevel level) { return level >= get_ui_log_level(); }
+// NOTE: compared as levels, comparing the level as an int against a compiled level of 0 trips -Wtype-limits
+static constexpr bool is_ui_log_level_compiled_in(UILogLevel level) {
+    return level >= static_cast<UILogLevel>(UI_COMPILED_LOG_LEVEL);
+}
 
-bool is_point_in_rectangle(const vertex_geometry::Rectangle &rect, const glm::vec2 &point) {
-    float half_width = rect.get_u_extent_size() / 2.0f;
-    float half_height = rect.get_v_extent_size() / 2.0f;
-
-    float left_bound = rect.center.x - half_width;
-    float right_bound = rect.center.x + half_width;
-    float bottom_bound = rect.center.y - half_height;
-    float top_bound = rect.center.y + half_height;
-
-    return (point.x >= left_bound && point.x <= right_bound && point.y >= bottom_bound && point.y <= top_bound);
+// NOTE: the arguments are only evaluated and formatted when the level is enabled, and when it isn't compiled in the
+// whole call is discarded at compile time
+#define UI_LOG(level, ...)                                                                                             \
+    do {                                                                                                               \
+        if constexpr (is_ui_log_level_compiled_in(UILogLevel::level)) {                                                \
+            if (is_ui_log_level_enabled(UILogLevel::level))                                                            \
+                global_logger->level(__VA_ARGS__);                                                                     \
+        }                                                                                                              \
+    } while (0)
+
+#if UI_COMPILED_LOG_LEVEL <= 1
+#define UI_LOG_SECTION(name)                                                                                           \
+    std::optional<LogSection> ui_log_section;                                                                          \
+    if (is_ui_log_level_enabled(UILogLevel::info))                                                                     \
+    ui_log_section.emplace(*global_logger, name)
+#else
+#define UI_LOG_SECTION(name)
+#endif
+
+// NOTE: with UI_COUNT_HEAP_ALLOCATIONS the program provides this, the library never replaces operator new itself
+#ifndef UI_COUNT_HEAP_ALLOCATIONS
+size_t get_heap_allocation_count() { return 0; }
+#endif
+
+UIEventQueue::UIEventQueue(size_t capacity) {
+    size_t power_of_two = 1;
+    while (power_of_two < capacity)
+        power_of_two <<= 1;
+    events.resize(power_of_two);
+    mask = power_of_two - 1;
 }
 
-void UI::process_mouse_position(const glm::vec2 &mouse_pos_ndc) {
+bool UIEventQueue::push(const UIEvent &event) {
+    return push(event.type, event.kind, event.id, event.option_index, event.text);
+}
 
-    for (auto &cr : clickable_text_boxes) {
-        if (is_point_in_rectangle(cr.rect, mouse_pos_ndc)) {
-            if (not cr.mouse_inside) {
-                std::vector<glm::vec3> cs(cr.ivpsc.xyz_positions.size(), cr.hover_color);
-                cr.ivpsc.rgb_colors = cs;
-                cr.ivpsc.buffer_modification_tracker.just_modified();
-                cr.mouse_inside = true;
-                cr.on_hover();
-            }
-        } else {
-            if (cr.mouse_inside) {
-                std::vector<glm::vec3> cs(cr.ivpsc.xyz_positions.size(), cr.regular_color);
-                cr.ivpsc.rgb_colors = cs;
-                cr.ivpsc.buffer_modification_tracker.just_modified();
-                cr.mouse_inside = false;
-            }
-        }
+bool UIEventQueue::push(UIEventType type, UIElementKind kind, int id, int option_index, std::string_view text) {
+    size_t current_tail = tail.load(std::memory_order_relaxed);
+    if (current_tail - head.load(std::memory_order_acquire) == events.size()) {
+        dropped_count.fetch_add(1, std::memory_order_relaxed);
+        return false;
     }
+    // NOTE: the slot keeps the storage of its text across uses, once the queue has warmed up pushing doesn't allocate
+    UIEvent &slot = events[current_tail & mask];
+    slot.type = type;
+    slot.kind = kind;
+    slot.id = id;
+    slot.option_index = option_index;
+    slot.text.assign(text);
+    tail.store(current_tail + 1, std::memory_order_release);
+    return true;
+}
 
-    for (auto &dd : dropdowns) {
-        if (is_point_in_rectangle(dd.dropdown_rect, mouse_pos_ndc)) {
-            if (not dd.mouse_inside) {
-                dd.on_hover();
-                std::vector<glm::vec3> cs(dd.dropdown_background.xyz_positions.size(), dd.hover_color);
-                dd.dropdown_background.rgb_colors = cs;
-                dd.dropdown_background.buffer_modification_tracker.just_modified();
-                dd.mouse_inside = true;
-            }
-        } else {
-            if (dd.mouse_inside) {
-                // dd.modified_signal.set_off();
-                std::vector<glm::vec3> cs(dd.dropdown_background.xyz_positions.size(), dd.regular_color);
-                dd.dropdown_background.rgb_colors = cs;
-                dd.dropdown_background.buffer_modification_tracker.just_modified();
-                dd.mouse_inside = false;
-            }
-        }
+bool UIEventQueue::pop(UIEvent &event) {
+    size_t current_head = head.load(std::memory_order_relaxed);
+    if (current_head == tail.load(std::memory_order_acquire)) {
+        return false;
     }
+    event = events[current_head & mask];
+    head.store(current_head + 1, std::memory_order_release);
+    return true;
+}
 
-    // because dropdowns and their options are spatially disjoint we can run both the above and below loop just fine
-
-    for (auto &dd : dropdowns) {
-        if (dd.dropdown_open) {
-            for (auto &udo : dd.ui_dropdown_options) {
-
-                auto dropdown_option_rect = udo.rect;
-                auto dropdown_option = udo.option;
+UICommandQueue::~UICommandQueue() {
+    // NOTE: queued nodes live in the blocks too, so there's nothing to drain
+    size_t allocated_block_count = std::min(block_count.load(std::memory_order_relaxed), max_block_count);
+    for (size_t block = 0; block < allocated_block_count; block++)
+        delete[] blocks[block].load(std::memory_order_relaxed);
+}
 
-                if (is_point_in_rectangle(dropdown_option_rect, mouse_pos_ndc)) {
-                    if (not udo.mouse_inside) {
-                        udo.on_hover(udo.option);
-                        std::vector<glm::vec3> cs(udo.background_ivpsc.xyz_positions.size(), udo.hover_color);
-                        udo.background_ivpsc.rgb_colors = cs;
-                        udo.background_ivpsc.buffer_modification_tracker.just_modified();
-                        udo.mouse_inside = true;
-                    }
-                } else {
-                    if (udo.mouse_inside) {
-                        std::vector<glm::vec3> cs(udo.background_ivpsc.xyz_positions.size(), udo.color);
-                        udo.background_ivpsc.rgb_colors = cs;
-                        udo.background_ivpsc.buffer_modification_tracker.just_modified();
-                        udo.mouse_inside = false;
-                    }
-                }
-            }
-        }
-    }
+UICommandQueue::Node &UICommandQueue::node_at(uint32_t pool_index) {
+    size_t index = pool_index - 1;
+    return blocks[index / nodes_per_block].load(std::memory_order_acquire)[index % nodes_per_block];
 }
 
-bool UI::process_mouse_just_clicked_on_clickable_textboxes(const glm::vec2 &mouse_pos_ndc) {
-    bool click_processed = false;
-    for (auto &cr : clickable_text_boxes) {
-        if (not click_processed and is_point_in_rectangle(cr.rect, mouse_pos_ndc)) {
-            cr.on_click();
-            // we don't want to propagate clicks through to multiple.
-            click_processed = true;
-        }
+UICommandQueue::Node *UICommandQueue::acquire_node() {
+    uint64_t old_free_head = free_head.load(std::memory_order_acquire);
+    while (static_cast<uint32_t>(old_free_head) != 0) {
+        Node &node = node_at(static_cast<uint32_t>(old_free_head));
+        uint64_t new_free_head = ((old_free_head >> 32) + 1) << 32 | node.next_free.load(std::memory_order_relaxed);
+        if (free_head.compare_exchange_weak(old_free_head, new_free_head, std::memory_order_acquire,
+                                            std::memory_order_acquire))
+            return &node;
     }
 
-    return click_processed;
+    // NOTE: the free list is empty, every producer that gets here adds a block of its own and keeps its first node
+    size_t block = block_count.fetch_add(1, std::memory_order_relaxed);
+    if (block >= max_block_count)
+        throw std::length_error("too many ui commands are queued, are they being applied every frame?");
+    Node *nodes = new Node[nodes_per_block];
+    for (size_t i = 0; i < nodes_per_block; i++)
+        nodes[i].pool_index = static_cast<uint32_t>(block * nodes_per_block + i + 1);
+    blocks[block].store(nodes, std::memory_order_release);
+    for (size_t i = 1; i < nodes_per_block; i++)
+        release_node(&nodes[i]);
+    return &nodes[0];
 }
 
-void UI::unfocus_input_box(UIInputBox &ib) {
-    ib.focused = false;
-    ib.already_ignored_initial_character_during_active_focus = false;
-    std::vector<glm::vec3> cs(ib.background_ivpsc.xyz_positions.size(), ib.regular_color);
-    if (ib.contents.size() == 0) { // put back placeholder
+void UICommandQueue::release_node(Node *node) {
+    uint64_t old_free_head = free_head.load(std::memory_order_relaxed);
+    uint64_t new_free_head;
+    do {
+        node->next_free.store(static_cast<uint32_t>(old_free_head), std::memory_order_relaxed);
+        new_free_head = ((old_free_head >> 32) + 1) << 32 | node->pool_index;
+    } while (not free_head.compare_exchange_weak(old_free_head, new_free_head, std::memory_order_release,
+                                                 std::memory_order_relaxed));
+}
 
-        draw_info::IndexedVertexPositions text_ivp = grid_font::get_text_geometry(ib.placeholder_text, ib.rect);
-        std::vector<glm::vec3> text_cs(text_ivp.xyz_positions.size(), glm::vec3(1, 1, 1));
-        draw_info::IVPColor text_ivpsc(text_ivp, text_cs,
-                                       ib.text_drawing_ivpsc.id); // maintining the same id
+void UICommandQueue::push(UICommand command) {
+    Node *node = acquire_node();
+    node->command = std::move(command);
+    node->next = head.load(std::memory_order_relaxed);
+    while (not head.compare_exchange_weak(node->next, node, std::memory_order_release, std::memory_order_relaxed)) {
+    }
+}
 
-        ib.text_drawing_ivpsc.copy_draw_data_from(text_ivpsc);
-        ib.text_drawing_ivpsc.buffer_modification_tracker.just_modified();
+void UICommandQueue::drain_newest_first(const std::function<void(UICommand &)> &process_command) {
+    // NOTE: since we take the whole list at once there's no ABA problem here, nodes are never popped one at a time
+    Node *node = head.exchange(nullptr, std::memory_order_acquire);
+    while (node != nullptr) {
+        process_command(node->command);
+        Node *next = node->next;
+        release_node(node);
+        node = next;
     }
-    // ib.modified_signal.toggle_state();
-    ib.background_ivpsc.rgb_colors = cs;
-    ib.background_ivpsc.buffer_modification_tracker.just_modified();
 }
 
-void UI::unfocus_input_box(int input_box_eid) { unfocus_input_box(*get_inputbox(input_box_eid)); }
+bool UI::queue_event(UIEventType type, UIElementKind kind, int id, int option_index, std::string_view text) {
+    if (event_dispatch != UIEventDispatch::event_queue) {
+        return false;
+    }
+    event_queue.push(type, kind, id, option_index, text);
+    return true;
+}
 
-void UI::focus_input_box(UIInputBox &ib) {
-    std::vector<glm::vec3> cs(ib.background_ivpsc.xyz_positions.size(), ib.focused_color);
-    ib.background_ivpsc.rgb_colors = cs;
+bool is_point_in_rectangle(const vertex_geometry::Rectangle &rect, const glm::vec2 &point) {
+    float half_width = rect.get_u_extent_size() / 2.0f;
+    float half_height = rect.get_v_extent_size() / 2.0f;
 
-    draw_info::IndexedVertexPositions text_ivp = grid_font::get_text_geometry(ib.contents, ib.rect);
-    std::vector<glm::vec3> text_cs(text_ivp.xyz_positions.size(), glm::vec3(1, 1, 1));
-    draw_info::IVPColor text_ivpsc(text_ivp, text_cs,
-                                   ib.text_drawing_ivpsc.id); // maintining the same id
+    float left_bound = rect.center.x - half_width;
+    float right_bound = rect.center.x + half_width;
+    float bottom_bound = rect.center.y - half_height;
+    float top_bound = rect.center.y + half_height;
 
-    ib.text_drawing_ivpsc.copy_draw_data_from(text_ivpsc);
-    ib.focused = true;
-    ib.text_drawing_ivpsc.buffer_modification_tracker.just_modified();
+    return (point.x >= left_bound && point.x <= right_bound && point.y >= bottom_bound && point.y <= top_bound);
 }
 
-void UI::focus_input_box(int input_box_eid) { focus_input_box(*get_inputbox(input_box_eid)); }
+TextGeometryCache &TextGeometryCache::get_shared() {
+    static TextGeometryCache shared_cache;
+    return shared_cache;
+}
 
-bool UI::process_mouse_just_clicked_on_input_boxes(const glm::vec2 &mouse_pos_ndc) {
-    bool click_processed = false;
-    for (auto &ib : input_boxes) {
-        bool click_inside_box = is_point_in_rectangle(ib.rect, mouse_pos_ndc);
-        if (not ib.focused) {
-            if (not click_processed and click_inside_box) {
-                focus_input_box(ib);
-                click_processed = true;
-            }
-        } else {
-            if (not click_inside_box) {
-                unfocus_input_box(ib);
-                ib.on_confirm(ib.contents);
-            }
-        }
-    }
-    return click_processed;
+size_t TextGeometryCache::KeyHash::operator()(const KeyView &key) const {
+    size_t hash = std::hash<std::string_view>{}(key.text);
+    hash ^= std::hash<float>{}(key.width) + 0x9e3779b9 + (hash << 6) + (hash >> 2);
+    hash ^= std::hash<float>{}(key.height) + 0x9e3779b9 + (hash << 6) + (hash >> 2);
+    return hash;
 }
 
-void UI::update_dropdown_option(UIDropdown &dropdown, const std::string &option_name) {
-    dropdown.selected_option = option_name;
+const draw_info::IndexedVertexPositions &TextGeometryCache::lookup(std::unique_lock<std::mutex> &lock,
+                                                                   std::string_view text,
+                                                                   const vertex_geometry::Rectangle &rect,
+                                                                   size_t *generation_count) {
+    KeyView key{text, rect.get_u_extent_size(), rect.get_v_extent_size()};
+
+    auto it = entries.find(key);
+    if (it != entries.end()) {
+        hit_count++;
+        lru_order.splice(lru_order.begin(), lru_order, it->second.lru_position);
+        return it->second.centered_ivp;
+    }
 
-    // NOTE: potentially make function that updates the main dropdown.
-    auto layered_rect = dropdown.dropdown_rect;
-    layered_rect.center.z = text_layer;
+    miss_count++;
+    if (generation_count != nullptr)
+        (*generation_count)++;
+
+    // NOTE: generating is the slow part, so we let go of the cache in the meantime which is what allows text to be
+    // generated on many threads at once
+    lock.unlock();
+    vertex_geometry::Rectangle centered_rect = rect;
+    centered_rect.center = glm::vec3(0);
+    std::string owned_text(text);
+    draw_info::IndexedVertexPositions centered_ivp = grid_font::get_text_geometry(owned_text, centered_rect);
+    lock.lock();
+
+    // another thread may have generated the same text while we weren't holding the lock
+    it = entries.find(key);
+    if (it != entries.end()) {
+        lru_order.splice(lru_order.begin(), lru_order, it->second.lru_position);
+        return it->second.centered_ivp;
+    }
 
-    draw_info::IndexedVertexPositions text_ivp = grid_font::get_text_geometry(dropdown.selected_option, layered_rect);
-    std::vector<glm::vec3> text_cs(text_ivp.xyz_positions.size(), glm::vec3(1, 1, 1));
-    draw_info::IVPColor text_ivpsc(text_ivp, text_cs,
-                                   dropdown.dropdown_text_ivpsc.id); // maintining the same id
+    lru_order.push_front(Key{std::move(owned_text), key.width, key.height});
+    auto [inserted, _] = entries.emplace(lru_order.front(), Entry{std::move(centered_ivp), lru_order.begin()});
+    // NOTE: the entry we just made is the most recently used so it's never the one that gets evicted
+    evict_until_within_capacity();
+    return inserted->second.centered_ivp;
+}
 
-    dropdown.dropdown_text_ivpsc.copy_draw_data_from(text_ivpsc);
-    dropdown.dropdown_text_ivpsc.buffer_modification_tracker.just_modified();
-    dropdown.dropdown_background.buffer_modification_tracker.just_modified();
-    // dropdown.modified_signal.toggle_state();
+void TextGeometryCache::evict_until_within_capacity() {
+    while (entries.size() > capacity and entries.size() > 1) {
+        entries.erase(lru_order.back());
+        lru_order.pop_back();
+    }
 }
 
-bool UI::process_mouse_just_clicked_on_dropdown_options(const glm::vec2 &mouse_pos_ndc) {
-    bool click_processed = false;
-    // TODO: process dropdown options
-    for (auto &dd : dropdowns) {
-        if (dd.dropdown_open) {
-            for (auto &udo : dd.ui_dropdown_options) {
+draw_info::IndexedVertexPositions TextGeometryCache::get_text_geometry(std::string_view text,
+                                                                       const vertex_geometry::Rectangle &rect,
+                                                                       size_t *generation_count) {
+    std::unique_lock<std::mutex> lock(mutex);
+    const auto &centered_ivp = lookup(lock, text, rect, generation_count);
 
-                auto dropdown_option_rect = udo.rect;
-                auto dropdown_option = udo.option;
+    draw_info::IndexedVertexPositions text_ivp;
+    text_ivp.indices = centered_ivp.indices;
+    text_ivp.xyz_positions.reserve(centered_ivp.xyz_positions.size());
+    for (const auto &position : centered_ivp.xyz_positions) {
+        text_ivp.xyz_positions.push_back(position + rect.center);
+    }
+    return text_ivp;
+}
 
-                bool clicked_inside = is_point_in_rectangle(dropdown_option_rect, mouse_pos_ndc);
+void TextGeometryCache::write_text_geometry(std::string_view text, const vertex_geometry::Rectangle &rect,
+                                            draw_info::IVPColor &ivpsc, bool per_vertex_colors,
+                                            size_t *generation_count) {
+    std::unique_lock<std::mutex> lock(mutex);
+    const auto &centered_ivp = lookup(lock, text, rect, generation_count);
 
-                if (clicked_inside) {
-                    udo.on_click(dropdown_option);
+    ivpsc.indices.assign(centered_ivp.indices.begin(), centered_ivp.indices.end());
+    ivpsc.xyz_positions.resize(centered_ivp.xyz_positions.size());
+    for (size_t i = 0; i < centered_ivp.xyz_positions.size(); i++) {
+        ivpsc.xyz_positions[i] = centered_ivp.xyz_positions[i] + rect.center;
+    }
+    if (per_vertex_colors) {
+        ivpsc.rgb_colors.assign(centered_ivp.xyz_positions.size(), glm::vec3(1, 1, 1));
+    } else {
+        ivpsc.rgb_colors.clear();
+    }
+    ivpsc.buffer_modification_tracker.just_modified();
+}
 
-                    update_dropdown_option(dd, udo.option);
+void TextGeometryCache::append_text_geometry(std::string_view text, const vertex_geometry::Rectangle &rect,
+                                             draw_info::IVPColor &ivpsc, bool per_vertex_colors,
+                                             size_t *generation_count) {
+    append_text_geometry(text, rect, ivpsc.xyz_positions, ivpsc.indices, generation_count);
+    if (per_vertex_colors) {
+        ivpsc.rgb_colors.resize(ivpsc.xyz_positions.size(), glm::vec3(1, 1, 1));
+    }
+}
 
-                    // we turn off the open dropdown after selecting an option
-                    dd.dropdown_open = false;
-                    click_processed = true;
+void TextGeometryCache::append_text_geometry(std::string_view text, const vertex_geometry::Rectangle &rect,
+                                             std::vector<glm::vec3> &xyz_positions,
+                                             std::vector<unsigned int> &indices, size_t *generation_count) {
+    std::unique_lock<std::mutex> lock(mutex);
+    const auto &centered_ivp = lookup(lock, text, rect, generation_count);
 
-                    break;
-                }
-            }
-        }
+    unsigned int vertex_offset = xyz_positions.size();
+    for (unsigned int index : centered_ivp.indices) {
+        indices.push_back(index + vertex_offset);
+    }
+    for (const auto &position : centered_ivp.xyz_positions) {
+        xyz_positions.push_back(position + rect.center);
     }
+}
 
-    return click_processed;
+size_t TextGeometryCache::get_hit_count() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return hit_count;
 }
 
-bool UI::process_mouse_just_clicked_on_dropdowns(const glm::vec2 &mouse_pos_ndc) {
-    bool click_processed = false;
-    for (auto &dd : dropdowns) {
-        bool click_inside_box = is_point_in_rectangle(dd.dropdown_rect, mouse_pos_ndc);
+size_t TextGeometryCache::get_miss_count() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return miss_count;
+}
+
+size_t TextGeometryCache::size() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return entries.size();
+}
+
+void TextGeometryCache::set_capacity(size_t new_capacity) {
+    std::lock_guard<std::mutex> lock(mutex);
+    capacity = new_capacity;
+    evict_until_within_capacity();
+}
 
-        if (not dd.dropdown_open) { // if that dropdown is not open, then we can potentially open it
+void TextGeometryCache::clear() {
+    std::lock_guard<std::mutex> lock(mutex);
+    entries.clear();
+    lru_order.clear();
+}
 
-            if (not click_processed and click_inside_box) {
+struct UIDirectoryListingCache::Listing::Job {
+    // NOTE: a cancelled job is no longer looked at, the thread only checks this to stop listing early
+    std::atomic<bool> cancelled{false};
+    std::mutex mutex;
+    // NOTE: guarded by the mutex, everything listed since the last poll
+    std::vector<UIDirectoryEntry> listed_entries;
+    bool finished = false;
+    std::string error;
+};
 
-                // change background color to the hovered color even though its a click (works but bad naming)
-                std::vector<glm::vec3> cs(dd.dropdown_background.xyz_positions.size(), dd.hover_color);
-                dd.dropdown_background.rgb_colors = cs;
+UIDirectoryListingCache::UIDirectoryListingCache(size_t capacity) : capacity(capacity) {}
 
-                // blank out the text box on click
+UIDirectoryListingCache::~UIDirectoryListingCache() {
+    for (auto &[directory, listing] : listings) {
+        stop_listing(listing);
+    }
+#ifdef __linux__
+    if (watch_file_descriptor >= 0) {
+        close(watch_file_descriptor);
+    }
+#endif
+}
 
-                auto layered_rect = dd.dropdown_rect;
-                layered_rect.center.z = text_layer;
+void UIDirectoryListingCache::start_listing(const std::string &directory, Listing &listing) {
+    stop_listing(listing);
+    listing.job = std::make_shared<Listing::Job>();
+
+    // NOTE: the thread keeps the job alive on its own, a single entry of a slow file system can take long to list and
+    // we don't want stop_listing to wait for that on the ui thread
+    std::thread([job_owner = listing.job, directory] {
+        Listing::Job &job = *job_owner;
+        // NOTE: entries are handed over in batches so that the lock isn't taken for every single one
+        constexpr size_t batch_size = 256;
+        std::vector<UIDirectoryEntry> batch;
+        auto hand_over_batch = [&] {
+            std::lock_guard<std::mutex> lock(job.mutex);
+            job.listed_entries.insert(job.listed_entries.end(), std::make_move_iterator(batch.begin()),
+                                      std::make_move_iterator(batch.end()));
+            batch.clear();
+        };
+
+        std::error_code error;
+        std::filesystem::directory_iterator it(directory, std::filesystem::directory_options::skip_permission_denied,
+                                               error);
+        for (; not error and it != std::filesystem::directory_iterator(); it.increment(error)) {
+            if (job.cancelled.load(std::memory_order_relaxed))
+                return;
+            std::error_code type_error;
+            batch.push_back({it->path().filename().string(), it->is_directory(type_error)});
+            if (batch.size() == batch_size)
+                hand_over_batch();
+        }
 
-                draw_info::IndexedVertexPositions text_ivp =
-                    grid_font::get_text_geometry(dd.selected_option, layered_rect);
-                std::vector<glm::vec3> text_cs(text_ivp.xyz_positions.size(), glm::vec3(1, 1, 1));
-                draw_info::IVPColor text_ivpsc(text_ivp, text_cs,
-                                               dd.dropdown_text_ivpsc.id); // maintining the same id
+        hand_over_batch();
+        std::lock_guard<std::mutex> lock(job.mutex);
+        if (error)
+            job.error = error.message();
+        job.finished = true;
+    }).detach();
+}
 
-                dd.dropdown_text_ivpsc = text_ivpsc;
-                dd.dropdown_text_ivpsc.buffer_modification_tracker.just_modified();
-                dd.dropdown_open = true;
-                // dd.modified_signal.toggle_state();
-                click_processed = true;
+void UIDirectoryListingCache::stop_listing(Listing &listing) {
+    if (not listing.job)
+        return;
+    listing.job->cancelled = true;
+    listing.job.reset();
+}
 
-                break;
-            }
-        } else { // the current dropdown is already open, so you can either deselect it or select one of its options, in
-                 // either way the dropdown becomes closed I think that makes sense
-
-            if (not click_inside_box) {
-                dd.dropdown_open = false;
-
-                /*std::vector<glm::vec3> cs(dd.background_ivpsc.xyz_positions.size(), dd.regular_color);*/
-                /*if (dd.contents.size() == 0) { // put back placeholder*/
-                /*    TextMesh tm = font_atlas.generate_text_mesh_size_constraints(*/
-                /*        dd.placeholder_text, dd.rect.center.x, dd.rect.center.y, dd.rect.width, dd.rect.height);*/
-                /*    IVPTextured ivpt(tm.indices, tm.vertex_positions, tm.texture_coordinates);*/
-                /*    dd.text_drawing_data = ivpt;*/
-                /*}*/
-                // dd.modified_signal.toggle_state();
-                /*dd.background_ivpsc.rgb_colors = cs;*/
+const UIDirectoryListingCache::Listing &UIDirectoryListingCache::request(const std::string &directory) {
+    request_count++;
+    auto [it, inserted] = listings.try_emplace(directory);
+    Listing &listing = it->second;
+    listing.last_requested = request_count;
+    if (not inserted)
+        return listing;
+
+    listing.generation = next_generation++;
+#ifdef __linux__
+    // NOTE: we start watching before listing, that way nothing that changes while we list goes unnoticed
+    if (watch_file_descriptor < 0) {
+        watch_file_descriptor = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    }
+    if (watch_file_descriptor >= 0) {
+        listing.watch_descriptor =
+            inotify_add_watch(watch_file_descriptor, directory.c_str(),
+                              IN_CREATE | IN_DELETE | IN_MOVED_FROM | IN_MOVED_TO | IN_DELETE_SELF | IN_MOVE_SELF |
+                                  IN_ONLYDIR);
+        if (listing.watch_descriptor >= 0)
+            directories_of_watch[listing.watch_descriptor].push_back(directory);
+    }
+#endif
+    start_listing(directory, listing);
+    // NOTE: the listing we just made is the most recently requested so it's never the one that gets evicted
+    evict_until_within_capacity();
+    return listing;
+}
+
+void UIDirectoryListingCache::evict_until_within_capacity() {
+    while (listings.size() > capacity and listings.size() > 1) {
+        auto least_recently_requested =
+            std::min_element(listings.begin(), listings.end(), [](const auto &a, const auto &b) {
+                return a.second.last_requested < b.second.last_requested;
+            });
+        Listing &listing = least_recently_requested->second;
+        stop_listing(listing);
+#ifdef __linux__
+        auto watch = directories_of_watch.find(listing.watch_descriptor);
+        if (watch != directories_of_watch.end()) {
+            auto &directories = watch->second;
+            directories.erase(std::find(directories.begin(), directories.end(), least_recently_requested->first));
+            if (directories.empty()) {
+                inotify_rm_watch(watch_file_descriptor, listing.watch_descriptor);
+                directories_of_watch.erase(watch);
             }
         }
+#endif
+        listings.erase(least_recently_requested);
     }
-    return click_processed;
 }
 
-void UI::process_mouse_just_clicked(const glm::vec2 &mouse_pos_ndc) {
-    if (process_mouse_just_clicked_on_dropdown_options(mouse_pos_ndc))
-        return;
-    if (process_mouse_just_clicked_on_clickable_textboxes(mouse_pos_ndc))
-        return;
-    if (process_mouse_just_clicked_on_input_boxes(mouse_pos_ndc))
-        return;
-    if (process_mouse_just_clicked_on_dropdowns(mouse_pos_ndc))
+void UIDirectoryListingCache::invalidate(const std::string &directory) {
+    auto it = listings.find(directory);
+    if (it == listings.end())
         return;
+
+    Listing &listing = it->second;
+    stop_listing(listing);
+    if (listing.complete) {
+        // NOTE: keep showing what we had until the new listing is complete
+        listing.relisting = true;
+        listing.relisted_entries.clear();
+    } else {
+        listing.entries.clear();
+        listing.generation = next_generation++;
+    }
+    listing.error.clear();
+    start_listing(directory, listing);
 }
 
-void UI::process_key_press(const std::string &character_pressed) {
-    for (auto &input_box : input_boxes) {
-        if (input_box.focused) {
-            // We only want to do this once though.
-            if (not input_box.already_ignored_initial_character_during_active_focus) {
-                if (input_box.initial_ignore_character == character_pressed) {
-                    input_box.already_ignored_initial_character_during_active_focus = true;
-                    continue;
+void UIDirectoryListingCache::process_file_system_changes() {
+#ifdef __linux__
+    if (watch_file_descriptor < 0)
+        return;
+
+    changed_watch_descriptors.clear();
+    alignas(inotify_event) char buffer[4096];
+    ssize_t length;
+    while ((length = read(watch_file_descriptor, buffer, sizeof(buffer))) > 0) {
+        for (char *position = buffer; position < buffer + length;) {
+            const auto *event = reinterpret_cast<const inotify_event *>(position);
+            position += sizeof(inotify_event) + event->len;
+
+            auto it = directories_of_watch.find(event->wd);
+            if (it == directories_of_watch.end())
+                continue;
+            // NOTE: the directory is gone, so is the watch
+            if (event->mask & IN_IGNORED) {
+                for (const auto &directory : it->second) {
+                    auto listing = listings.find(directory);
+                    if (listing != listings.end())
+                        listing->second.watch_descriptor = -1;
                 }
+                directories_of_watch.erase(it);
+                continue;
             }
-            input_box.contents += character_pressed;
+            changed_watch_descriptors.push_back(event->wd);
+        }
+    }
 
-            draw_info::IndexedVertexPositions text_ivp =
-                grid_font::get_text_geometry(input_box.contents, input_box.rect);
-            std::vector<glm::vec3> text_cs(text_ivp.xyz_positions.size(), glm::vec3(1, 1, 1));
-            draw_info::IVPColor text_ivpsc(text_ivp, text_cs,
-                                           input_box.text_drawing_ivpsc.id); // maintining the same id
+    // NOTE: a single change usually comes with many events, but we only want to list each directory again once
+    std::sort(changed_watch_descriptors.begin(), changed_watch_descriptors.end());
+    changed_watch_descriptors.erase(std::unique(changed_watch_descriptors.begin(), changed_watch_descriptors.end()),
+                                    changed_watch_descriptors.end());
+    for (int watch_descriptor : changed_watch_descriptors) {
+        auto it = directories_of_watch.find(watch_descriptor);
+        if (it == directories_of_watch.end())
+            continue;
+        for (const auto &directory : it->second)
+            invalidate(directory);
+    }
+#endif
+}
 
-            input_box.text_drawing_ivpsc.copy_draw_data_from(text_ivpsc);
-            input_box.text_drawing_ivpsc.buffer_modification_tracker.just_modified();
-            // input_box.modified_signal.toggle_state();
-            break; // only one thing ever focused.
+void UIDirectoryListingCache::poll() {
+    process_file_system_changes();
+
+    for (auto &[directory, listing] : listings) {
+        if (not listing.job)
+            continue;
+
+        Listing::Job &job = *listing.job;
+        bool finished;
+        {
+            std::lock_guard<std::mutex> lock(job.mutex);
+            auto &entries = listing.relisting ? listing.relisted_entries : listing.entries;
+            entries.insert(entries.end(), std::make_move_iterator(job.listed_entries.begin()),
+                           std::make_move_iterator(job.listed_entries.end()));
+            job.listed_entries.clear();
+            finished = job.finished;
+            listing.error = job.error;
+        }
+        if (not finished)
+            continue;
+
+        listing.job.reset();
+        listing.complete = true;
+        if (listing.relisting) {
+            listing.entries.swap(listing.relisted_entries);
+            listing.relisted_entries.clear();
+            listing.relisting = false;
+            listing.generation = next_generation++;
         }
     }
 }
 
-void UI::process_confirm_action() {
-    for (auto &input_box : input_boxes) {
-        if (input_box.focused) {
-            input_box.on_confirm(input_box.contents);
-
-            // after hitting enter go back to regular non focused mode.
-            input_box.focused = false;
-            input_box.already_ignored_initial_character_during_active_focus = false;
-            std::vector<glm::vec3> cs(input_box.background_ivpsc.xyz_positions.size(), input_box.regular_color);
-            draw_info::IVPColor ivpsc(input_box.background_ivpsc.indices, input_box.background_ivpsc.xyz_positions, cs);
-            input_box.background_ivpsc = ivpsc;
-            input_box.background_ivpsc.buffer_modification_tracker.just_modified();
-            // input_box.modified_signal.toggle_state();
+void UIBufferRange::merge(size_t other_first, size_t other_count) {
+    if (other_count == 0) {
+        return;
+    }
+    if (empty()) {
+        first = other_first;
+        count = other_count;
+        return;
+    }
+    size_t last = std::max(first + count, other_first + other_count);
+    first = std::min(first, other_first);
+    count = last - first;
+}
 
-            break;
+void UIModifiedBuffers::mark(draw_info::IVPColor &ivpsc, uint8_t attributes, UIBufferRange vertices,
+                             UIBufferRange indices) {
+    ivpsc.buffer_modification_tracker.just_modified();
+
+    int index = index_of_buffer(ivpsc.id);
+    if (index == -1) {
+        if (ivpsc.id >= 0) {
+            reserve_slot();
+            buffer_slots[find_slot(ivpsc.id)] = {static_cast<int>(modifications.size()), generation};
         }
+        modifications.push_back({ivpsc.id, attributes, vertices, indices});
+        return;
     }
+
+    auto &modification = modifications[index];
+    modification.attributes |= attributes;
+    modification.vertices.merge(vertices.first, vertices.count);
+    modification.indices.merge(indices.first, indices.count);
 }
 
-void UI::process_delete_action() {
-    for (auto &input_box : input_boxes) {
-        if (input_box.focused) {
-            if (input_box.contents.size() >= 1) {
-                input_box.contents = input_box.contents.substr(0, input_box.contents.size() - 1);
-            }
-            std::string text_to_use = input_box.contents;
-            if (input_box.contents.size() == 0) {
-                text_to_use = input_box.placeholder_text;
-            }
+void UIModifiedBuffers::mark(draw_info::IVPColor &ivpsc, UIBufferAttribute attribute, UIBufferRange vertices) {
+    mark(ivpsc, static_cast<uint8_t>(attribute), vertices);
+}
 
-            draw_info::IndexedVertexPositions text_ivp = grid_font::get_text_geometry(text_to_use, input_box.rect);
-            std::vector<glm::vec3> text_cs(text_ivp.xyz_positions.size(), glm::vec3(1, 1, 1));
-            draw_info::IVPColor text_ivpsc(text_ivp, text_cs,
-                                           input_box.text_drawing_ivpsc.id); // maintining the same id
+void UIModifiedBuffers::mark_everything(draw_info::IVPColor &ivpsc) {
+    mark(ivpsc, UIBufferAttribute::positions | UIBufferAttribute::colors | UIBufferAttribute::indices,
+         {0, ivpsc.xyz_positions.size()}, {0, ivpsc.indices.size()});
+}
 
-            input_box.text_drawing_ivpsc.copy_draw_data_from(text_ivpsc);
-            input_box.text_drawing_ivpsc.buffer_modification_tracker.just_modified();
-            // input_box.modified_signal.toggle_state();
-            break; // only one thing ever focused.
-        }
+int UIModifiedBuffers::index_of_buffer(int buffer_id) const {
+    if (buffer_id >= 0) {
+        if (buffer_slots.empty())
+            return -1;
+        size_t slot = find_slot(buffer_id);
+        return is_slot_used(slot) ? buffer_slots[slot].modification_index : -1;
+    }
+    // NOTE: buffers without a real id can't be looked up by it, there are never many of those
+    for (size_t i = 0; i < modifications.size(); i++) {
+        if (modifications[i].buffer_id == buffer_id)
+            return static_cast<int>(i);
     }
+    return -1;
 }
 
-void UI::add_colored_rectangle(vertex_geometry::Rectangle ndc_rectangle, const glm::vec3 &normalized_rgb) {
+size_t UIModifiedBuffers::find_slot(int buffer_id) const {
+    // NOTE: ids are handed out one after the other, so the id itself already spreads them over the table
+    size_t mask = buffer_slots.size() - 1;
+    for (size_t slot = static_cast<size_t>(buffer_id) & mask;; slot = (slot + 1) & mask) {
+        if (not is_slot_used(slot) or modifications[buffer_slots[slot].modification_index].buffer_id == buffer_id)
+            return slot;
+    }
+}
 
-    int element_id = ui_id_generator.get_id();
+void UIModifiedBuffers::erase_slot(size_t slot) {
+    // NOTE: the entries after the hole that wouldn't be found anymore are moved back into it, so no tombstones needed
+    size_t mask = buffer_slots.size() - 1;
+    size_t hole = slot;
+    buffer_slots[hole] = {};
+    for (size_t next = (hole + 1) & mask; is_slot_used(next); next = (next + 1) & mask) {
+        size_t home = static_cast<size_t>(modifications[buffer_slots[next].modification_index].buffer_id) & mask;
+        bool reachable_past_hole = hole <= next ? (hole < home and home <= next) : (hole < home or home <= next);
+        if (reachable_past_hole)
+            continue;
+        buffer_slots[hole] = buffer_slots[next];
+        buffer_slots[next] = {};
+        hole = next;
+    }
+}
 
-    // NOTE: I don't think we need to do this because now the batcher checks to see if something has an id and if it
-    // doesn't it automatically gets one
-    int rect_id = abs_pos_object_id_generator.get_id();
+void UIModifiedBuffers::reserve_slot() {
+    size_t slot_count = std::max<size_t>(buffer_slots.size(), 64);
+    while ((modifications.size() + 1) * 2 > slot_count)
+        slot_count *= 2;
+    if (slot_count == buffer_slots.size())
+        return;
 
-    auto ivp = ndc_rectangle.get_ivp();
-    draw_info::IVPColor ivpc(ivp, normalized_rgb);
-    ivpc.id = rect_id;
+    buffer_slots.assign(slot_count, {});
+    generation = 1;
+    for (size_t i = 0; i < modifications.size(); i++) {
+        if (modifications[i].buffer_id >= 0)
+            buffer_slots[find_slot(modifications[i].buffer_id)] = {static_cast<int>(i), generation};
+    }
+}
 
-    global_logger->info("adding colored rectangle with element id: {} rect_id: {}", element_id, rect_id);
+void UIModifiedBuffers::forget(int buffer_id) {
+    int index = index_of_buffer(buffer_id);
+    if (index == -1) {
+        return;
+    }
 
-    rectangles.emplace_back(ivpc, element_id);
+    if (buffer_id >= 0)
+        erase_slot(find_slot(buffer_id));
+    if (index != static_cast<int>(modifications.size()) - 1) {
+        modifications[index] = modifications.back();
+        // NOTE: the slot of the moved modification still points at the back, which has the same buffer id
+        if (modifications[index].buffer_id >= 0)
+            buffer_slots[find_slot(modifications[index].buffer_id)].modification_index = index;
+    }
+    modifications.pop_back();
+}
 
-    // TODO: should this not reutrn the element id too?
+void UIModifiedBuffers::clear() {
+    modifications.clear();
+    if (++generation == 0) {
+        buffer_slots.assign(buffer_slots.size(), {});
+        generation = 1;
+    }
 }
 
-void UI::add_colored_rectangle(float x_pos_ndc, float y_pos_ndc, float width, float height,
-                               const glm::vec3 &normalized_rgb) {
+size_t UIModifiedBuffers::get_modified_byte_count() const {
+    size_t byte_count = 0;
+    for (const auto &modification : modifications) {
+        if (modification.has(UIBufferAttribute::positions))
+            byte_count += modification.vertices.count * sizeof(glm::vec3);
+        if (modification.has(UIBufferAttribute::colors))
+            byte_count += modification.vertices.count * sizeof(glm::vec3);
+        if (modification.has(UIBufferAttribute::indices))
+            byte_count += modification.indices.count * sizeof(unsigned int);
+        if (modification.has(UIBufferAttribute::uniform_color))
+            byte_count += sizeof(glm::vec3);
+    }
+    return byte_count;
+}
 
-    int element_id = ui_id_generator.get_id();
+/**
+ * @brief calls process with every index from 0 up to count, spread across the cores of the machine
+ *
+ * @note returns once every index was processed, when there isn't much to do it all happens on the calling thread since
+ * starting threads would take longer than the work itself.
+ */
+static void parallel_for(size_t count, const std::function<void(size_t)> &process) {
+    constexpr size_t min_count_per_thread = 32;
+    size_t thread_count = std::min<size_t>(std::max(1u, std::thread::hardware_concurrency()),
+                                           count / min_count_per_thread);
+    if (thread_count <= 1) {
+        for (size_t i = 0; i < count; i++) {
+            process(i);
+        }
+        return;
+    }
 
-    auto is = vertex_geometry::generate_rectangle_indices();
-    auto vs = vertex_geometry::generate_rectangle_vertices(x_pos_ndc, y_pos_ndc, width, height);
-    int rect_id = abs_pos_object_id_generator.get_id();
+    std::atomic<size_t> next_index{0};
+    auto process_remaining = [&] {
+        for (size_t i = next_index++; i < count; i = next_index++) {
+            process(i);
+        }
+    };
 
-    global_logger->info("adding colored rectangle with element id: {} rect_id: {}", element_id, rect_id);
+    std::vector<std::thread> threads;
+    for (size_t i = 1; i < thread_count; i++) {
+        threads.emplace_back(process_remaining);
+    }
+    process_remaining();
+    for (auto &thread : threads) {
+        thread.join();
+    }
+}
 
-    std::vector<glm::vec3> cs(vs.size(), normalized_rgb);
-    draw_info::IVPColor ivpsc(is, vs, cs, rect_id);
-    rectangles.emplace_back(ivpsc, element_id);
+/**
+ * @brief breaks the text into lines at newlines and when wrapping words also so that no line is longer than
+ * max_line_length, a word which is longer than that on its own gets split up
+ *
+ * the lines view the text, a wrapped line is always the words it holds along with the spaces between them.
+ */
+static void break_text_into_lines(std::string_view text, UITextWrap wrap, size_t max_line_length,
+                                  std::vector<std::string_view> &lines) {
+    lines.clear();
+    size_t paragraph_start = 0;
+    while (true) {
+        size_t paragraph_end = std::min(text.find('\n', paragraph_start), text.size());
+        std::string_view paragraph = text.substr(paragraph_start, paragraph_end - paragraph_start);
+
+        if (wrap == UITextWrap::newlines) {
+            lines.push_back(paragraph);
+        } else {
+            size_t line_start = 0, line_end = 0;
+            size_t word_start = 0;
+            while (word_start <= paragraph.size()) {
+                size_t word_end = std::min(paragraph.find(' ', word_start), paragraph.size());
+                std::string_view word = paragraph.substr(word_start, word_end - word_start);
+                size_t word_position = word_start;
+                word_start = word_end + 1;
+
+                if (line_end > line_start and line_end - line_start + 1 + word.size() > max_line_length) {
+                    lines.push_back(paragraph.substr(line_start, line_end - line_start));
+                    line_start = line_end = word_position;
+                }
+                while (word.size() > max_line_length) {
+                    lines.push_back(word.substr(0, max_line_length));
+                    word.remove_prefix(max_line_length);
+                    word_position += max_line_length;
+                }
+                if (line_end == line_start)
+                    line_start = word_position;
+                line_end = word_position + word.size();
+            }
+            lines.push_back(paragraph.substr(line_start, line_end - line_start));
+        }
+
+        if (paragraph_end == text.size())
+            break;
+        paragraph_start = paragraph_end + 1;
+    }
 }
 
-int UI::add_textbox(const std::string &text, vertex_geometry::Rectangle ndc_text_rectangle,
-                    const glm::vec3 &normalized_rgb) {
-    return this->add_textbox(text, ndc_text_rectangle.center.x, ndc_text_rectangle.center.y,
-                             ndc_text_rectangle.get_u_extent_size(), ndc_text_rectangle.get_v_extent_size(),
-                             normalized_rgb);
+static float get_text_line_advance(const UITextLayout &layout) { return layout.line_height * 0.5f; }
+
+static vertex_geometry::Rectangle get_text_line_rectangle(const UITextLayout &layout,
+                                                          const vertex_geometry::Rectangle &rect,
+                                                          std::string_view line, size_t line_index,
+                                                          size_t line_count) {
+    if (layout.wrap == UITextWrap::words) {
+        float width = line.size() * get_text_line_advance(layout);
+        float left = rect.center.x - rect.get_u_extent_size() / 2.0f;
+        float top = rect.center.y + rect.get_v_extent_size() / 2.0f;
+        glm::vec3 center(left + width / 2.0f, top - layout.line_height * (line_index + 0.5f), rect.center.z);
+        return vertex_geometry::Rectangle(center, width, layout.line_height);
+    }
+    if (line_count == 1)
+        return rect;
+    return vertex_geometry::Grid(line_count, 1, rect).get_at(0, line_index);
 }
 
-int UI::add_textbox(const std::string &text, float center_x_pos_ndc, float center_y_pos_ndc, float width, float height,
-                    const glm::vec3 &normalized_rgb) {
+static bool is_text_line_drawn(const UITextLayout &layout, const vertex_geometry::Rectangle &rect,
+                               size_t line_index) {
+    return layout.wrap == UITextWrap::newlines or
+           layout.line_height * (line_index + 1) <= rect.get_v_extent_size() + 1e-4f;
+}
 
-    // this id is for grabbing an element from the UI object
-    int element_id = ui_id_generator.get_id();
-    // these are internal ones used to clean up UI elements when deleted.
-    int rect_id = abs_pos_object_id_generator.get_id();
-    int text_data_id = abs_pos_object_id_generator.get_id();
+/**
+ * @brief breaks the text into lines and writes their geometry, re-using the geometry of the lines that didn't change
+ *
+ * the lines at the start that are the same as before are left alone and the lines at the end that are the same are
+ * only moved into place, only the ones in between get their geometry generated. This relies on layout.lines describing
+ * what's currently in the positions and indices, pass reuse_geometry false when that isn't the case.
+ *
+ * @return the first vertex and the first index that were written
+ */
+static std::pair<size_t, size_t> lay_out_text(UITextLayout &layout, std::string_view text,
+                                              const vertex_geometry::Rectangle &rect,
+                                              std::vector<glm::vec3> &xyz_positions,
+                                              std::vector<unsigned int> &indices, size_t &generation_count,
+                                              bool reuse_geometry = true) {
+    // NOTE: scratch space kept around so that laying text out doesn't allocate, thread local since elements added
+    // together are laid out in parallel
+    thread_local std::vector<std::string_view> new_line_texts;
+    thread_local std::vector<glm::vec3> suffix_positions;
+    thread_local std::vector<unsigned int> suffix_indices;
+
+    size_t max_line_length = 0;
+    if (layout.wrap == UITextWrap::words)
+        max_line_length = std::max<size_t>(1, rect.get_u_extent_size() / get_text_line_advance(layout));
+    break_text_into_lines(text, layout.wrap, max_line_length, new_line_texts);
+
+    auto &lines = layout.lines;
+    size_t old_count = lines.size(), new_count = new_line_texts.size();
+    // NOTE: without wrapping the rectangle of every line depends on how many lines there are
+    bool lines_keep_their_rectangles = layout.wrap == UITextWrap::words or old_count == new_count;
+    size_t common_count = reuse_geometry and lines_keep_their_rectangles ? std::min(old_count, new_count) : 0;
+
+    size_t prefix = 0;
+    while (prefix < common_count and lines[prefix].text == new_line_texts[prefix])
+        prefix++;
+    size_t suffix = 0;
+    while (prefix + suffix < common_count) {
+        size_t old_index = old_count - 1 - suffix, new_index = new_count - 1 - suffix;
+        if (lines[old_index].text != new_line_texts[new_index] or
+            is_text_line_drawn(layout, rect, old_index) != is_text_line_drawn(layout, rect, new_index))
+            break;
+        suffix++;
+    }
 
-    global_logger->info("adding textbox with contents: {} element id: {} rect_id: {} text_data_id: {}", text,
-                        element_id, rect_id, text_data_id);
+    size_t first_vertex = 0, first_index = 0;
+    if (prefix > 0) {
+        const auto &geometry = lines[prefix - 1].geometry;
+        first_vertex = geometry.first_vertex + geometry.vertex_count;
+        first_index = geometry.first_index + geometry.index_count;
+    }
 
-    auto is = vertex_geometry::generate_rectangle_indices();
-    auto vs = vertex_geometry::generate_rectangle_vertices_with_z(center_x_pos_ndc, center_y_pos_ndc, background_layer,
-                                                                  width, height);
-    std::vector<glm::vec3> cs(vs.size(), normalized_rgb);
-    draw_info::IVPColor ivpsc(is, vs, cs, rect_id);
+    // NOTE: the geometry of the lines at the end is moved aside since the lines in between get written over it
+    suffix_positions.clear();
+    suffix_indices.clear();
+    size_t suffix_first_vertex = 0;
+    if (suffix > 0) {
+        const auto &geometry = lines[old_count - suffix].geometry;
+        suffix_first_vertex = geometry.first_vertex;
+        suffix_positions.assign(xyz_positions.begin() + geometry.first_vertex, xyz_positions.end());
+        suffix_indices.assign(indices.begin() + geometry.first_index, indices.end());
+    }
+    xyz_positions.resize(first_vertex);
+    indices.resize(first_index);
+
+    // NOTE: the lines in between are rotated rather than erased and inserted, so that their strings keep their capacity
+    if (new_count > old_count) {
+        lines.resize(new_count);
+        std::rotate(lines.begin() + old_count - suffix, lines.begin() + old_count, lines.end());
+    } else if (new_count < old_count) {
+        std::rotate(lines.begin() + new_count - suffix, lines.begin() + old_count - suffix, lines.end());
+        lines.resize(new_count);
+    }
+    for (size_t i = prefix; i < new_count - suffix; i++) {
+        auto &line = lines[i];
+        line.text.assign(new_line_texts[i]);
+        line.geometry = {xyz_positions.size(), 0, indices.size(), 0};
+        if (is_text_line_drawn(layout, rect, i)) {
+            TextGeometryCache::get_shared().append_text_geometry(
+                line.text, get_text_line_rectangle(layout, rect, line.text, i, new_count), xyz_positions, indices,
+                &generation_count);
+        }
+        line.geometry.vertex_count = xyz_positions.size() - line.geometry.first_vertex;
+        line.geometry.index_count = indices.size() - line.geometry.first_index;
+    }
 
-    // TODO: do we really need this, we're already storing this in two places! that's why the below line is commented
-    // the problem is that in the renderer we will iterate over the rectangles and  textboxes elements the problem is
-    // that when we store in two places whichever one is selected last will be rendered first causing the issue because
-    // they use the same rect id
-    //    rectangles.emplace_back(ivpsc, element_id); // used here
+    if (suffix > 0) {
+        // NOTE: lines only ever move up or down by whole lines, and only when wrapping since otherwise the line count
+        // had to stay the same for them to be re-used
+        float y_offset = (static_cast<float>(old_count) - static_cast<float>(new_count)) * layout.line_height;
+        long vertex_shift = static_cast<long>(xyz_positions.size()) - static_cast<long>(suffix_first_vertex);
+        long index_shift = static_cast<long>(indices.size()) -
+                           static_cast<long>(lines[new_count - suffix].geometry.first_index);
+        for (const auto &position : suffix_positions)
+            xyz_positions.push_back(position + glm::vec3(0, y_offset, 0));
+        for (unsigned int index : suffix_indices)
+            indices.push_back(index + vertex_shift);
+        for (size_t i = new_count - suffix; i < new_count; i++) {
+            lines[i].geometry.first_vertex += vertex_shift;
+            lines[i].geometry.first_index += index_shift;
+        }
+    }
 
-    // NOTE: adding rectangles so that we can check for intersection easier
-    glm::vec3 center(center_x_pos_ndc, center_y_pos_ndc, text_layer);
-    vertex_geometry::Rectangle bounding_rect(center, width, height);
+    return {first_vertex, first_index};
+}
 
-    // NOTE: here we have special logic for if a string contains newlines
+/**
+ * @brief the text geometry of a newly created element, along with the layout it was made with
+ */
+static draw_info::IndexedVertexPositions generate_text_layout(UITextLayout &layout, const std::string &text,
+                                                              const vertex_geometry::Rectangle &rect,
+                                                              size_t &generation_count) {
     draw_info::IndexedVertexPositions text_ivp;
-    bool contains_newline = text.find('\n') != std::string::npos;
-    if (contains_newline) {
-        size_t newline_count = std::count(text.begin(), text.end(), '\n');
-        vertex_geometry::Grid text_lines_grid(newline_count + 1, 1, bounding_rect);
-
-        std::istringstream stream(text);
-        std::string line;
+    lay_out_text(layout, text, rect, text_ivp.xyz_positions, text_ivp.indices, generation_count);
+    layout.text = text;
+    return text_ivp;
+}
 
-        std::vector<draw_info::IndexedVertexPositions> line_ivps;
-        int count = 0;
-        while (std::getline(stream, line)) {
-            auto line_rect = text_lines_grid.get_at(0, count);
-            line_ivps.push_back(grid_font::get_text_geometry(line, line_rect));
-            count++;
-        }
+void UI::write_text_layout(UITextLayout &layout, std::string text, const vertex_geometry::Rectangle &rect,
+                           draw_info::IVPColor &ivpsc, bool reuse_geometry) {
+    size_t old_vertex_count = ivpsc.xyz_positions.size(), old_index_count = ivpsc.indices.size();
+    auto [first_vertex, first_index] =
+        lay_out_text(layout, text, rect, ivpsc.xyz_positions, ivpsc.indices, text_geometry_generation_count,
+                     reuse_geometry);
+    layout.text = std::move(text);
+    if (uses_per_vertex_colors())
+        ivpsc.rgb_colors.resize(ivpsc.xyz_positions.size(), glm::vec3(1, 1, 1));
+
+    size_t vertex_count = ivpsc.xyz_positions.size(), index_count = ivpsc.indices.size();
+    if (first_vertex == vertex_count and vertex_count == old_vertex_count and first_index == index_count and
+        index_count == old_index_count)
+        return;
+    // NOTE: only what comes after the lines that stayed the same gets uploaded again
+    modified_buffers.mark(ivpsc, get_text_geometry_attributes(), {first_vertex, vertex_count - first_vertex},
+                          {first_index, index_count - first_index});
+}
 
-        text_ivp = vertex_geometry::merge_ivps(line_ivps);
+void UI::redo_text_layout(UITextLayout &layout, const vertex_geometry::Rectangle &rect, draw_info::IVPColor &ivpsc) {
+    std::string text = std::move(layout.text);
+    write_text_layout(layout, std::move(text), rect, ivpsc, false);
+}
 
-    } else {
-        text_ivp = grid_font::get_text_geometry(text, bounding_rect);
+/**
+ * @brief generates white text drawing data for a newly created element
+ */
+static draw_info::IVPColor generate_text_ivpsc(const std::string &text, const vertex_geometry::Rectangle &rect, int id,
+                                               bool per_vertex_colors, size_t &generation_count) {
+    draw_info::IndexedVertexPositions text_ivp =
+        TextGeometryCache::get_shared().get_text_geometry(text, rect, &generation_count);
+    std::vector<glm::vec3> text_cs;
+    if (per_vertex_colors) {
+        text_cs.assign(text_ivp.xyz_positions.size(), glm::vec3(1, 1, 1));
     }
+    return draw_info::IVPColor(text_ivp, text_cs, id);
+}
 
-    std::vector<glm::vec3> text_cs(text_ivp.xyz_positions.size(), glm::vec3(1, 1, 1));
-    draw_info::IVPColor text_ivpsc(text_ivp, text_cs, text_data_id);
-
-    UITextBox tb(ivpsc, text_ivpsc, bounding_rect, element_id); // used here
-    text_boxes.emplace_back(tb);
-
-    global_logger->info("bg id: {}", tb.background_ivpsc.id);
-    global_logger->info("text id: {}", tb.text_drawing_ivpsc.id);
+std::vector<glm::vec3> UI::generate_vertex_colors(size_t vertex_count, const glm::vec3 &color) const {
+    if (not uses_per_vertex_colors()) {
+        return {};
+    }
+    return std::vector<glm::vec3>(vertex_count, color);
+}
 
-    return element_id;
-};
+void UI::set_background_color(draw_info::IVPColor &ivpsc, glm::vec3 &background_color, const glm::vec3 &color) {
+    if (background_color == color) {
+        return;
+    }
+    background_color = color;
+    background_quads_dirty = true;
 
-void UI::hide_textbox(int doid) {
-    // Find the textbox with the given ID
-    UITextBox *textbox = get_textbox(doid);
-    textbox->hidden = true;
+    if (not uses_per_vertex_colors()) {
+        modified_buffers.mark(ivpsc, UIBufferAttribute::uniform_color, {});
+        return;
+    }
+    std::fill(ivpsc.rgb_colors.begin(), ivpsc.rgb_colors.end(), color);
+    modified_buffers.mark(ivpsc, UIBufferAttribute::colors, {0, ivpsc.rgb_colors.size()});
 }
 
-void UI::unhide_textbox(int doid) {
-    // Find the textbox with the given ID
-    UITextBox *textbox = get_textbox(doid);
-    textbox->hidden = false;
+uint8_t UI::get_text_geometry_attributes() const {
+    uint8_t attributes = UIBufferAttribute::positions | UIBufferAttribute::indices;
+    if (uses_per_vertex_colors()) {
+        attributes = attributes | UIBufferAttribute::colors;
+    }
+    return attributes;
 }
 
-void UI::modify_text_of_a_textbox(int doid, std::string new_text) {
-    // Find the textbox with the given ID
-    UITextBox *textbox = get_textbox(doid);
+vertex_geometry::Rectangle compute_bounding_rectangle(const std::vector<glm::vec3> &xyz_positions) {
+    if (xyz_positions.empty()) {
+        return vertex_geometry::Rectangle(glm::vec3(0), 0, 0);
+    }
 
-    if (textbox != nullptr) {
-        // Modify the text mesh with the new text
+    glm::vec3 min_corner = xyz_positions[0];
+    glm::vec3 max_corner = xyz_positions[0];
+    for (const auto &position : xyz_positions) {
+        min_corner.x = std::min(min_corner.x, position.x);
+        min_corner.y = std::min(min_corner.y, position.y);
+        max_corner.x = std::max(max_corner.x, position.x);
+        max_corner.y = std::max(max_corner.y, position.y);
+    }
 
-        draw_info::IndexedVertexPositions text_ivp = grid_font::get_text_geometry(new_text, textbox->bounding_rect);
+    glm::vec3 center((min_corner.x + max_corner.x) / 2.0f, (min_corner.y + max_corner.y) / 2.0f, xyz_positions[0].z);
+    return vertex_geometry::Rectangle(center, max_corner.x - min_corner.x, max_corner.y - min_corner.y);
+}
 
-        // NOTE: we re-use the drawing data id to avoid a ivp leak, else we'd have to delete and regenerate which we
-        // won't do.
+UISpatialGrid::UISpatialGrid(int cells_per_axis)
+    : cells_per_axis(cells_per_axis), cells(cells_per_axis * cells_per_axis) {}
 
-        std::vector<glm::vec3> text_cs(text_ivp.xyz_positions.size(), glm::vec3(1, 1, 1));
+int UISpatialGrid::cell_coordinate(float ndc) const {
+    int coordinate = static_cast<int>(std::floor((ndc + 1.0f) / 2.0f * cells_per_axis));
+    return std::clamp(coordinate, 0, cells_per_axis - 1);
+}
 
-        textbox->text_drawing_ivpsc = draw_info::IVPColor(text_ivp, text_cs, textbox->text_drawing_ivpsc.id);
-        textbox->text_drawing_ivpsc.buffer_modification_tracker.just_modified();
-        // textbox->modified_signal.toggle_state();
-    }
+uint64_t UIHitTestTable::key_of(const UISpatialEntry &entry) {
+    return (static_cast<uint64_t>(static_cast<uint32_t>(entry.id)) << 32) |
+           (static_cast<uint64_t>(entry.kind) << 24) | (static_cast<uint32_t>(entry.option_index + 1) & 0xffffff);
 }
 
-void UI::modify_colored_rectangle(int doid, vertex_geometry::Rectangle ndc_rectangle) {
+uint32_t UIHitTestTable::add(const UISpatialEntry &entry, const vertex_geometry::Rectangle &rect,
+                             uint8_t initial_flags) {
+    uint32_t slot;
+    if (free_slots.empty()) {
+        slot = static_cast<uint32_t>(entries.size());
+        min_x.emplace_back();
+        min_y.emplace_back();
+        max_x.emplace_back();
+        max_y.emplace_back();
+        flags.emplace_back();
+        entries.emplace_back();
+    } else {
+        slot = free_slots.back();
+        free_slots.pop_back();
+    }
+
+    float half_width = rect.get_u_extent_size() / 2.0f;
+    float half_height = rect.get_v_extent_size() / 2.0f;
+    min_x[slot] = rect.center.x - half_width;
+    max_x[slot] = rect.center.x + half_width;
+    min_y[slot] = rect.center.y - half_height;
+    max_y[slot] = rect.center.y + half_height;
+    flags[slot] = initial_flags;
+    entries[slot] = entry;
+    entries[slot].hit_slot = slot;
+    slot_of_key[key_of(entry)] = slot;
+    return slot;
+}
+
+void UIHitTestTable::remove(uint32_t slot) {
+    slot_of_key.erase(key_of(entries[slot]));
+    // NOTE: an empty box can't contain any point, so a stale slot can never be hit
+    min_x[slot] = min_y[slot] = 1;
+    max_x[slot] = max_y[slot] = -1;
+    flags[slot] = 0;
+    free_slots.push_back(slot);
+}
+
+uint32_t UIHitTestTable::find(const UISpatialEntry &entry) const {
+    auto it = slot_of_key.find(key_of(entry));
+    return it == slot_of_key.end() ? no_slot : it->second;
+}
+
+void UISpatialGrid::insert(uint32_t slot, const vertex_geometry::Rectangle &rect) {
+    float half_width = rect.get_u_extent_size() / 2.0f;
+    float half_height = rect.get_v_extent_size() / 2.0f;
+
+    int min_x = cell_coordinate(rect.center.x - half_width);
+    int max_x = cell_coordinate(rect.center.x + half_width);
+    int min_y = cell_coordinate(rect.center.y - half_height);
+    int max_y = cell_coordinate(rect.center.y + half_height);
+
+    for (int y = min_y; y <= max_y; y++) {
+        for (int x = min_x; x <= max_x; x++) {
+            cells[y * cells_per_axis + x].push_back(slot);
+        }
+    }
+}
+
+void UISpatialGrid::remove(uint32_t slot, const vertex_geometry::Rectangle &rect) {
+    float half_width = rect.get_u_extent_size() / 2.0f;
+    float half_height = rect.get_v_extent_size() / 2.0f;
+
+    int min_x = cell_coordinate(rect.center.x - half_width);
+    int max_x = cell_coordinate(rect.center.x + half_width);
+    int min_y = cell_coordinate(rect.center.y - half_height);
+    int max_y = cell_coordinate(rect.center.y + half_height);
+
+    for (int y = min_y; y <= max_y; y++) {
+        for (int x = min_x; x <= max_x; x++) {
+            auto &cell = cells[y * cells_per_axis + x];
+            auto it = std::find(cell.begin(), cell.end(), slot);
+            if (it != cell.end()) {
+                // NOTE: order within a cell doesn't matter, so we can swap and pop
+                *it = cell.back();
+                cell.pop_back();
+            }
+        }
+    }
+}
+
+void UISpatialGrid::clear() {
+    for (auto &cell : cells) {
+        cell.clear();
+    }
+}
+
+const std::vector<uint32_t> &UISpatialGrid::query(const glm::vec2 &point) const {
+    return cells[cell_coordinate(point.y) * cells_per_axis + cell_coordinate(point.x)];
+}
+
+/**
+ * @brief elements which were added first get to take the click, the same as when we used to loop over every element.
+ */
+static bool has_higher_hit_priority(const UISpatialEntry &a, const UISpatialEntry &b) {
+    if (a.kind != b.kind)
+        return a.kind < b.kind;
+    if (a.order != b.order)
+        return a.order < b.order;
+    return a.option_index < b.option_index;
+}
+
+const vertex_geometry::Rectangle &UI::get_entry_rectangle(const UISpatialEntry &entry) {
+    switch (entry.kind) {
+    case UIElementKind::colored_rectangle:
+        return rectangles.at(entry.id).bounding_rect;
+    case UIElementKind::textbox:
+        return text_boxes.at(entry.id).bounding_rect;
+    case UIElementKind::clickable_textbox:
+        return clickable_text_boxes.at(entry.id).rect;
+    case UIElementKind::input_box:
+        return input_boxes.at(entry.id).rect;
+    case UIElementKind::dropdown:
+        return dropdowns.at(entry.id).dropdown_rect;
+    case UIElementKind::scroll_list_row:
+        return scroll_lists.at(entry.id).rows[entry.option_index].bounding_rect;
+    case UIElementKind::log:
+        return logs.at(entry.id).rect;
+    case UIElementKind::dropdown_option:
+    default:
+        return dropdowns.at(entry.id).ui_dropdown_options[entry.option_index].rect;
+    }
+}
+
+const glm::vec3 &UI::get_entry_background_color(const UISpatialEntry &entry) {
+    switch (entry.kind) {
+    case UIElementKind::colored_rectangle:
+        return rectangles.at(entry.id).background_color;
+    case UIElementKind::textbox:
+        return text_boxes.at(entry.id).background_color;
+    case UIElementKind::clickable_textbox:
+        return clickable_text_boxes.at(entry.id).background_color;
+    case UIElementKind::input_box:
+        return input_boxes.at(entry.id).background_color;
+    case UIElementKind::dropdown:
+        return dropdowns.at(entry.id).background_color;
+    case UIElementKind::scroll_list_row:
+        return scroll_lists.at(entry.id).rows[entry.option_index].background_color;
+    case UIElementKind::log:
+        return logs.at(entry.id).background_color;
+    case UIElementKind::dropdown_option:
+    default:
+        return dropdowns.at(entry.id).ui_dropdown_options[entry.option_index].background_color;
+    }
+}
+
+void UI::collect_entries_under_point(const glm::vec2 &point) {
+    hit_entries.clear();
+    // NOTE: only the dense bounds and flags are looked at here, the elements themselves are never touched
+    for (uint32_t slot : spatial_grid.query(point)) {
+        if (not hit_test_table.has_flag(slot, UIHitTestTable::inactive_flag) and hit_test_table.contains(slot, point))
+            hit_entries.push_back(hit_test_table.get_entry(slot));
+    }
+    std::sort(hit_entries.begin(), hit_entries.end(), has_higher_hit_priority);
+}
+
+bool UI::is_entry_hovered(const UISpatialEntry &entry) {
+    return hit_test_table.has_flag(entry.hit_slot, UIHitTestTable::hovered_flag);
+}
+
+void UI::set_entry_hovered(const UISpatialEntry &entry, bool hovered) {
+    // NOTE: input boxes don't react to hovering
+    if (entry.kind != UIElementKind::input_box)
+        hit_test_table.set_flag(entry.hit_slot, UIHitTestTable::hovered_flag, hovered);
+
+    switch (entry.kind) {
+    case UIElementKind::colored_rectangle:
+        rectangles.at(entry.id).mouse_above = hovered;
+        break;
+    case UIElementKind::textbox:
+        text_boxes.at(entry.id).mouse_above = hovered;
+        break;
+    case UIElementKind::log:
+        logs.at(entry.id).mouse_above = hovered;
+        break;
+    case UIElementKind::clickable_textbox: {
+        auto &cr = clickable_text_boxes.at(entry.id);
+        set_background_color(cr.ivpsc, cr.background_color, hovered ? cr.hover_color : cr.regular_color);
+        cr.mouse_inside = hovered;
+        if (hovered and not queue_event(UIEventType::hovered, entry.kind, entry.id))
+            cr.on_hover();
+        break;
+    }
+    case UIElementKind::dropdown: {
+        auto &dd = dropdowns.at(entry.id);
+        if (hovered and not queue_event(UIEventType::hovered, entry.kind, entry.id))
+            dd.on_hover();
+        set_background_color(dd.dropdown_background, dd.background_color, hovered ? dd.hover_color : dd.regular_color);
+        dd.mouse_inside = hovered;
+        break;
+    }
+    case UIElementKind::dropdown_option: {
+        auto &dd = dropdowns.at(entry.id);
+        auto &udo = dd.ui_dropdown_options[entry.option_index];
+        if (hovered and not queue_event(UIEventType::hovered, entry.kind, entry.id, entry.option_index, udo.option))
+            dd.option_on_hover(udo.option);
+        set_background_color(udo.background_ivpsc, udo.background_color, hovered ? udo.hover_color : udo.color);
+        udo.mouse_inside = hovered;
+        break;
+    }
+    case UIElementKind::scroll_list_row: {
+        auto &sl = scroll_lists.at(entry.id);
+        auto &row = sl.rows[entry.option_index];
+        long item = sl.item_index_of_row(entry.option_index);
+        if (hovered and item >= 0 and
+            not queue_event(UIEventType::hovered, entry.kind, entry.id, static_cast<int>(item), sl.items[item]))
+            sl.on_hover(item, sl.items[item]);
+        set_background_color(row.background_ivpsc, row.background_color, hovered ? sl.hover_color : sl.regular_color);
+        row.mouse_above = hovered;
+        break;
+    }
+    case UIElementKind::input_box:
+        // input boxes don't react to hovering
+        break;
+    }
+}
+
+void UI::process_mouse_position(const glm::vec2 &mouse_pos_ndc) {
+    collect_entries_under_point(mouse_pos_ndc);
+
+    // un-hover everything that the mouse is no longer above, options of closed dropdowns aren't tested at all so they
+    // keep whatever state they had
+    for (const auto &entry : hovered_entries) {
+        if (entry.kind == UIElementKind::dropdown_option and
+            hit_test_table.has_flag(entry.hit_slot, UIHitTestTable::inactive_flag))
+            continue;
+        bool still_inside = std::find(hit_entries.begin(), hit_entries.end(), entry) != hit_entries.end();
+        // NOTE: a row that now shows another item counts as left, so that it gets hovered again below with that item
+        if (entry.kind == UIElementKind::scroll_list_row) {
+            auto &sl = scroll_lists.at(entry.id);
+            if (sl.hovered_row_changed) {
+                still_inside = false;
+                sl.hovered_row_changed = false;
+            }
+        }
+        if (not still_inside)
+            set_entry_hovered(entry, false);
+    }
+    hovered_entries.erase(std::remove_if(hovered_entries.begin(), hovered_entries.end(),
+                                         [this](const UISpatialEntry &entry) { return not is_entry_hovered(entry); }),
+                          hovered_entries.end());
+
+    for (const auto &entry : hit_entries) {
+        if (entry.kind == UIElementKind::input_box or is_entry_hovered(entry))
+            continue;
+        set_entry_hovered(entry, true);
+        hovered_entries.push_back(entry);
+    }
+}
+
+bool UI::process_mouse_just_clicked_on_clickable_textboxes(const glm::vec2 &mouse_pos_ndc) {
+    collect_entries_under_point(mouse_pos_ndc);
+    for (const auto &entry : hit_entries) {
+        if (entry.kind == UIElementKind::clickable_textbox) {
+            if (not queue_event(UIEventType::clicked, entry.kind, entry.id))
+                clickable_text_boxes.at(entry.id).on_click();
+            // we don't want to propagate clicks through to multiple.
+            return true;
+        }
+    }
+
+    return false;
+}
+
+/**
+ * @brief how far apart the characters of an input box are
+ *
+ * characters get cells half as wide as they are tall no matter how many there are, which means adding one doesn't move
+ * any of those before it, the ones that don't fit are scrolled out of view instead of being squished.
+ */
+static float get_input_box_glyph_advance(const UIInputBox &ib) { return ib.rect.get_v_extent_size() * 0.5f; }
+
+/// @return how many characters fit into the box, at least one so that the caret always has something to show
+static size_t get_input_box_visible_glyph_count(const UIInputBox &ib) {
+    // NOTE: a little slack so that a width which is an exact multiple of the advance isn't lost to rounding
+    float fitting_glyph_count = ib.rect.get_u_extent_size() / get_input_box_glyph_advance(ib);
+    return std::max<size_t>(1, static_cast<size_t>(fitting_glyph_count + 1e-3f));
+}
+
+static bool is_input_box_caret_visible(const UIInputBox &ib) {
+    return ib.first_visible_glyph <= ib.caret_position and
+           ib.caret_position <= ib.first_visible_glyph + get_input_box_visible_glyph_count(ib);
+}
+
+/**
+ * @brief scrolls the box so that the caret ends up in the middle of it
+ * @note scrolling by half a box rather than a character at a time means typing past the edge only lays the box out
+ * again every so often
+ */
+static void center_input_box_on_caret(UIInputBox &ib) {
+    size_t half_visible_glyph_count = get_input_box_visible_glyph_count(ib) / 2;
+    ib.first_visible_glyph =
+        ib.caret_position > half_visible_glyph_count ? ib.caret_position - half_visible_glyph_count : 0;
+}
+
+/// @param position the position of the character in the contents, which has to be visible
+static vertex_geometry::Rectangle get_input_box_glyph_cell(const UIInputBox &ib, size_t position) {
+    float advance = get_input_box_glyph_advance(ib);
+    float left_edge = ib.rect.center.x - ib.rect.get_u_extent_size() / 2.0f;
+    glm::vec3 center(left_edge + advance * (position - ib.first_visible_glyph + 0.5f), ib.rect.center.y,
+                     ib.rect.center.z);
+    return vertex_geometry::Rectangle(center, advance, ib.rect.get_v_extent_size());
+}
+
+/**
+ * @brief regenerates the geometry of every visible character of the contents, scrolling to the caret if it isn't
+ * visible, only required when the box scrolls or changes size
+ */
+void UI::layout_input_box_contents(UIInputBox &ib) {
+    if (ib.contents_layout.wrap == UITextWrap::words) {
+        ib.glyph_ranges.clear();
+        ib.showing_placeholder = false;
+        write_wrapped_input_box_contents(ib, false);
+        return;
+    }
+
+    if (not is_input_box_caret_visible(ib))
+        center_input_box_on_caret(ib);
+
+    // NOTE: clearing keeps the capacity, so laying the box out again doesn't allocate, the glyph ranges get room for
+    // the glyph that inserting pushes past the edge before it's erased so that typing never grows them
+    size_t visible_glyph_count = get_input_box_visible_glyph_count(ib);
+    auto &ivpsc = ib.text_drawing_ivpsc;
+    ivpsc.indices.clear();
+    ivpsc.xyz_positions.clear();
+    ivpsc.rgb_colors.clear();
+    ib.glyph_ranges.clear();
+    ib.glyph_ranges.reserve(visible_glyph_count + 1);
+    ib.showing_placeholder = false;
+
+    size_t end = std::min(ib.contents.size(), ib.first_visible_glyph + visible_glyph_count);
+    for (size_t i = ib.first_visible_glyph; i < end; i++) {
+        UIGlyphRange range{ivpsc.xyz_positions.size(), 0, ivpsc.indices.size(), 0};
+        TextGeometryCache::get_shared().append_text_geometry(std::string_view(ib.contents).substr(i, 1),
+                                                             get_input_box_glyph_cell(ib, i), ivpsc,
+                                                             uses_per_vertex_colors(), &text_geometry_generation_count);
+        range.vertex_count = ivpsc.xyz_positions.size() - range.first_vertex;
+        range.index_count = ivpsc.indices.size() - range.first_index;
+        ib.glyph_ranges.push_back(range);
+    }
+
+    modified_buffers.mark_everything(ivpsc);
+}
+
+void UI::show_input_box_placeholder(UIInputBox &ib) {
+    // NOTE: the contents were written over the placeholder so none of its lines can be re-used
+    ib.placeholder_layout.text = ib.placeholder_text;
+    redo_text_layout(ib.placeholder_layout, ib.rect, ib.text_drawing_ivpsc);
+    ib.glyph_ranges.clear();
+    ib.first_visible_glyph = 0;
+    ib.showing_placeholder = true;
+}
+
+/**
+ * @brief lays the contents of a box that wraps words out like any other text, re-using the lines that didn't change
+ */
+void UI::write_wrapped_input_box_contents(UIInputBox &ib, bool reuse_geometry) {
+    // NOTE: the layout's own string is handed back in so that its capacity gets re-used instead of copying contents
+    std::string text = std::move(ib.contents_layout.text);
+    text.assign(ib.contents);
+    write_text_layout(ib.contents_layout, std::move(text), ib.rect, ib.text_drawing_ivpsc, reuse_geometry);
+}
+
+void UI::translate_input_box_glyph(UIInputBox &ib, size_t glyph, float x_offset) {
+    const auto &range = ib.glyph_ranges[glyph];
+    for (size_t v = range.first_vertex; v < range.first_vertex + range.vertex_count; v++) {
+        ib.text_drawing_ivpsc.xyz_positions[v].x += x_offset;
+    }
+    modified_buffers.mark(ib.text_drawing_ivpsc, UIBufferAttribute::positions,
+                          {range.first_vertex, range.vertex_count});
+}
+
+/**
+ * @brief generates the geometry of a character and puts it in front of the visible glyph at the given index
+ *
+ * the geometry is added at the end of the buffers and then rotated into place, so only the geometry of the glyphs after
+ * it moves, which is also all that is marked as modified.
+ */
+void UI::insert_input_box_glyph(UIInputBox &ib, size_t glyph, char character) {
+    auto &ivpsc = ib.text_drawing_ivpsc;
+    size_t old_vertex_count = ivpsc.xyz_positions.size(), old_index_count = ivpsc.indices.size();
+    bool is_last = glyph == ib.glyph_ranges.size();
+    UIGlyphRange range{is_last ? old_vertex_count : ib.glyph_ranges[glyph].first_vertex, 0,
+                       is_last ? old_index_count : ib.glyph_ranges[glyph].first_index, 0};
+
+    TextGeometryCache::get_shared().append_text_geometry(std::string_view(&character, 1),
+                                                         get_input_box_glyph_cell(ib, ib.first_visible_glyph + glyph),
+                                                         ivpsc, uses_per_vertex_colors(),
+                                                         &text_geometry_generation_count);
+    range.vertex_count = ivpsc.xyz_positions.size() - old_vertex_count;
+    range.index_count = ivpsc.indices.size() - old_index_count;
+
+    if (not is_last) {
+        std::rotate(ivpsc.xyz_positions.begin() + range.first_vertex, ivpsc.xyz_positions.begin() + old_vertex_count,
+                    ivpsc.xyz_positions.end());
+        if (uses_per_vertex_colors()) {
+            std::rotate(ivpsc.rgb_colors.begin() + range.first_vertex, ivpsc.rgb_colors.begin() + old_vertex_count,
+                        ivpsc.rgb_colors.end());
+        }
+        std::rotate(ivpsc.indices.begin() + range.first_index, ivpsc.indices.begin() + old_index_count,
+                    ivpsc.indices.end());
+
+        // NOTE: the new indices still refer to where the vertices were appended, the ones after them to where their
+        // vertices were before the new ones got in front of them
+        size_t new_indices_end = range.first_index + range.index_count;
+        for (size_t i = range.first_index; i < new_indices_end; i++)
+            ivpsc.indices[i] -= old_vertex_count - range.first_vertex;
+        for (size_t i = new_indices_end; i < ivpsc.indices.size(); i++)
+            ivpsc.indices[i] += range.vertex_count;
+        for (size_t i = glyph; i < ib.glyph_ranges.size(); i++) {
+            ib.glyph_ranges[i].first_vertex += range.vertex_count;
+            ib.glyph_ranges[i].first_index += range.index_count;
+        }
+    }
+
+    ib.glyph_ranges.insert(ib.glyph_ranges.begin() + glyph, range);
+    modified_buffers.mark(ivpsc, get_text_geometry_attributes(),
+                          {range.first_vertex, ivpsc.xyz_positions.size() - range.first_vertex},
+                          {range.first_index, ivpsc.indices.size() - range.first_index});
+}
+
+/**
+ * @brief removes the geometry of the visible glyph at the given index, the geometry of the glyphs after it shifts down
+ * to fill the gap, which for the last one is nothing at all
+ */
+void UI::erase_input_box_glyph(UIInputBox &ib, size_t glyph) {
+    auto &ivpsc = ib.text_drawing_ivpsc;
+    UIGlyphRange removed = ib.glyph_ranges[glyph];
+
+    ivpsc.xyz_positions.erase(ivpsc.xyz_positions.begin() + removed.first_vertex,
+                              ivpsc.xyz_positions.begin() + removed.first_vertex + removed.vertex_count);
+    if (uses_per_vertex_colors()) {
+        ivpsc.rgb_colors.erase(ivpsc.rgb_colors.begin() + removed.first_vertex,
+                               ivpsc.rgb_colors.begin() + removed.first_vertex + removed.vertex_count);
+    }
+    ivpsc.indices.erase(ivpsc.indices.begin() + removed.first_index,
+                        ivpsc.indices.begin() + removed.first_index + removed.index_count);
+
+    // NOTE: the geometry is in the order of the glyphs, so only the glyphs after the removed one refer to vertices
+    // after it
+    for (size_t i = removed.first_index; i < ivpsc.indices.size(); i++) {
+        ivpsc.indices[i] -= removed.vertex_count;
+    }
+    ib.glyph_ranges.erase(ib.glyph_ranges.begin() + glyph);
+    for (size_t i = glyph; i < ib.glyph_ranges.size(); i++) {
+        ib.glyph_ranges[i].first_vertex -= removed.vertex_count;
+        ib.glyph_ranges[i].first_index -= removed.index_count;
+    }
+
+    modified_buffers.mark(ivpsc, get_text_geometry_attributes(),
+                          {removed.first_vertex, ivpsc.xyz_positions.size() - removed.first_vertex},
+                          {removed.first_index, ivpsc.indices.size() - removed.first_index});
+}
+
+/**
+ * @brief inserts a character into the contents at the position and moves the caret after it, only the geometry of
+ * that character is generated
+ *
+ * characters after it are slid over by one cell and the one pushed past the edge of the box loses its geometry, when
+ * the caret would end up past the edge the box scrolls instead.
+ */
+void UI::insert_input_box_character(UIInputBox &ib, size_t position, char character) {
+    ib.contents.insert(position, 1, character);
+    ib.caret_position = position + 1;
+    if (ib.contents_layout.wrap == UITextWrap::words) {
+        write_wrapped_input_box_contents(ib, true);
+        return;
+    }
+
+    if (position < ib.first_visible_glyph or not is_input_box_caret_visible(ib)) {
+        layout_input_box_contents(ib);
+        return;
+    }
+
+    size_t glyph = position - ib.first_visible_glyph;
+    insert_input_box_glyph(ib, glyph, character);
+
+    float advance = get_input_box_glyph_advance(ib);
+    for (size_t i = glyph + 1; i < ib.glyph_ranges.size(); i++) {
+        translate_input_box_glyph(ib, i, advance);
+    }
+    if (ib.glyph_ranges.size() > get_input_box_visible_glyph_count(ib)) {
+        erase_input_box_glyph(ib, ib.glyph_ranges.size() - 1);
+    }
+}
+
+/**
+ * @brief removes the character at the position from the contents and moves the caret to where it was, along with its
+ * geometry
+ *
+ * characters after it are slid back by one cell and the next one that didn't fit into the box yet gets geometry, when
+ * the character isn't visible the box scrolls instead.
+ */
+void UI::erase_input_box_character(UIInputBox &ib, size_t position) {
+    ib.contents.erase(position, 1);
+    ib.caret_position = position;
+    if (ib.contents_layout.wrap == UITextWrap::words) {
+        write_wrapped_input_box_contents(ib, true);
+        return;
+    }
+
+    if (position < ib.first_visible_glyph or position >= ib.first_visible_glyph + ib.glyph_ranges.size()) {
+        layout_input_box_contents(ib);
+        return;
+    }
+
+    size_t glyph = position - ib.first_visible_glyph;
+    erase_input_box_glyph(ib, glyph);
+
+    float advance = get_input_box_glyph_advance(ib);
+    for (size_t i = glyph; i < ib.glyph_ranges.size(); i++) {
+        translate_input_box_glyph(ib, i, -advance);
+    }
+    size_t next_hidden = ib.first_visible_glyph + ib.glyph_ranges.size();
+    if (next_hidden < ib.contents.size()) {
+        insert_input_box_glyph(ib, ib.glyph_ranges.size(), ib.contents[next_hidden]);
+    }
+}
+
+void UI::unfocus_input_box(UIInputBox &ib) {
+    focused_input_box_ids.erase(std::remove(focused_input_box_ids.begin(), focused_input_box_ids.end(), ib.id),
+                                focused_input_box_ids.end());
+
+    ib.focused = false;
+    ib.already_ignored_initial_character_during_active_focus = false;
+    if (ib.contents.size() == 0) { // put back placeholder
+        show_input_box_placeholder(ib);
+    }
+    // ib.modified_signal.toggle_state();
+    set_background_color(ib.background_ivpsc, ib.background_color, ib.regular_color);
+}
+
+void UI::unfocus_input_box(int input_box_eid) { unfocus_input_box(*get_inputbox(input_box_eid)); }
+
+void UI::focus_input_box(UIInputBox &ib) {
+    set_background_color(ib.background_ivpsc, ib.background_color, ib.focused_color);
+
+    ib.caret_position = ib.contents.size();
+    layout_input_box_contents(ib);
+    if (not ib.focused) {
+        focused_input_box_ids.push_back(ib.id);
+    }
+    ib.focused = true;
+}
+
+void UI::focus_input_box(int input_box_eid) { focus_input_box(*get_inputbox(input_box_eid)); }
+
+bool UI::process_mouse_just_clicked_on_input_boxes(const glm::vec2 &mouse_pos_ndc) {
+    // clicking anywhere outside of a focused box confirms it, note that unfocusing removes it from the focused ids
+    for (size_t i = 0; i < focused_input_box_ids.size();) {
+        auto &ib = input_boxes.at(focused_input_box_ids[i]);
+        if (is_point_in_rectangle(ib.rect, mouse_pos_ndc)) {
+            i++;
+            continue;
+        }
+        unfocus_input_box(ib);
+        if (not queue_event(UIEventType::confirmed, UIElementKind::input_box, ib.id, -1, ib.contents))
+            ib.on_confirm(ib.contents);
+    }
+
+    collect_entries_under_point(mouse_pos_ndc);
+    for (const auto &entry : hit_entries) {
+        if (entry.kind == UIElementKind::input_box and not input_boxes.at(entry.id).focused) {
+            focus_input_box(input_boxes.at(entry.id));
+            return true;
+        }
+    }
+    return false;
+}
+
+void UI::set_dropdown_open(UIDropdown &dropdown, bool open) {
+    if (open != dropdown.dropdown_open) {
+        render_list_dirty = true;
+    }
+    if (open and not dropdown.dropdown_open) {
+        open_dropdown_ids.push_back(dropdown.id);
+    } else if (not open and dropdown.dropdown_open) {
+        open_dropdown_ids.erase(std::remove(open_dropdown_ids.begin(), open_dropdown_ids.end(), dropdown.id),
+                                open_dropdown_ids.end());
+    }
+    dropdown.dropdown_open = open;
+
+    for (int i = 0; i < static_cast<int>(dropdown.ui_dropdown_options.size()); i++) {
+        uint32_t slot = hit_test_table.find({UIElementKind::dropdown_option, dropdown.id, i});
+        if (slot != UIHitTestTable::no_slot)
+            hit_test_table.set_flag(slot, UIHitTestTable::inactive_flag, not open);
+    }
+}
+
+void UI::update_dropdown_option(UIDropdown &dropdown, const std::string &option_name) {
+    dropdown.selected_option = option_name;
+
+    // NOTE: potentially make function that updates the main dropdown.
+    auto layered_rect = dropdown.dropdown_rect;
+    layered_rect.center.z = text_layer;
+
+    TextGeometryCache::get_shared().write_text_geometry(dropdown.selected_option, layered_rect,
+                                                        dropdown.dropdown_text_ivpsc, uses_per_vertex_colors(),
+                                                        &text_geometry_generation_count);
+    modified_buffers.mark_everything(dropdown.dropdown_text_ivpsc);
+    // dropdown.modified_signal.toggle_state();
+}
+
+bool UI::process_mouse_just_clicked_on_dropdown_options(const glm::vec2 &mouse_pos_ndc) {
+    bool click_processed = false;
+    collect_entries_under_point(mouse_pos_ndc);
+    for (const auto &entry : hit_entries) {
+        if (entry.kind != UIElementKind::dropdown_option)
+            continue;
+
+        auto &dd = dropdowns.at(entry.id);
+        // only the first option under the mouse of each dropdown counts, after that the dropdown is closed
+        if (not dd.dropdown_open)
+            continue;
+
+        auto &udo = dd.ui_dropdown_options[entry.option_index];
+        if (not queue_event(UIEventType::clicked, entry.kind, entry.id, entry.option_index, udo.option))
+            dd.option_on_click(udo.option);
+
+        update_dropdown_option(dd, udo.option);
+
+        // we turn off the open dropdown after selecting an option
+        set_dropdown_open(dd, false);
+        click_processed = true;
+    }
+
+    return click_processed;
+}
+
+bool UI::process_mouse_just_clicked_on_dropdowns(const glm::vec2 &mouse_pos_ndc) {
+    // the open dropdowns can either be deselected or have one of their options selected, either way they become closed
+    // I think that makes sense, note that closing one removes it from the open ids
+    for (size_t i = 0; i < open_dropdown_ids.size();) {
+        auto &dd = dropdowns.at(open_dropdown_ids[i]);
+        if (is_point_in_rectangle(dd.dropdown_rect, mouse_pos_ndc)) {
+            i++;
+            continue;
+        }
+        set_dropdown_open(dd, false);
+    }
+
+    collect_entries_under_point(mouse_pos_ndc);
+    for (const auto &entry : hit_entries) {
+        if (entry.kind != UIElementKind::dropdown or dropdowns.at(entry.id).dropdown_open)
+            continue;
+
+        auto &dd = dropdowns.at(entry.id);
+
+        // change background color to the hovered color even though its a click (works but bad naming)
+        set_background_color(dd.dropdown_background, dd.background_color, dd.hover_color);
+
+        // blank out the text box on click
+
+        auto layered_rect = dd.dropdown_rect;
+        layered_rect.center.z = text_layer;
+
+        TextGeometryCache::get_shared().write_text_geometry(dd.selected_option, layered_rect, dd.dropdown_text_ivpsc,
+                                                            uses_per_vertex_colors(), &text_geometry_generation_count);
+        modified_buffers.mark_everything(dd.dropdown_text_ivpsc);
+        set_dropdown_open(dd, true);
+        // dd.modified_signal.toggle_state();
+
+        return true;
+    }
+    return false;
+}
+
+bool UI::process_mouse_just_clicked_on_scroll_lists(const glm::vec2 &mouse_pos_ndc) {
+    collect_entries_under_point(mouse_pos_ndc);
+    for (const auto &entry : hit_entries) {
+        if (entry.kind != UIElementKind::scroll_list_row)
+            continue;
+        // NOTE: rows past the end of the items are never hit, so there is always an item here
+        auto &sl = scroll_lists.at(entry.id);
+        long item = sl.item_index_of_row(entry.option_index);
+        if (not queue_event(UIEventType::clicked, entry.kind, entry.id, static_cast<int>(item), sl.items[item]))
+            sl.on_click(item, sl.items[item]);
+        return true;
+    }
+    return false;
+}
+
+void UI::process_mouse_scroll(const glm::vec2 &mouse_pos_ndc, float scroll_amount) {
+    if (scroll_amount == 0)
+        return;
+    collect_entries_under_point(mouse_pos_ndc);
+    for (const auto &entry : hit_entries) {
+        if (entry.kind != UIElementKind::scroll_list_row)
+            continue;
+        auto &sl = scroll_lists.at(entry.id);
+        // NOTE: scrolling up moves towards the start of the list
+        sl.unapplied_scroll -= scroll_amount;
+        long row_offset = static_cast<long>(sl.unapplied_scroll);
+        sl.unapplied_scroll -= row_offset;
+        if (row_offset != 0)
+            scroll_list_by(entry.id, row_offset);
+        return;
+    }
+}
+
+void UI::process_mouse_just_clicked(const glm::vec2 &mouse_pos_ndc) {
+    if (process_mouse_just_clicked_on_dropdown_options(mouse_pos_ndc))
+        return;
+    if (process_mouse_just_clicked_on_clickable_textboxes(mouse_pos_ndc))
+        return;
+    if (process_mouse_just_clicked_on_input_boxes(mouse_pos_ndc))
+        return;
+    if (process_mouse_just_clicked_on_scroll_lists(mouse_pos_ndc))
+        return;
+    if (process_mouse_just_clicked_on_dropdowns(mouse_pos_ndc))
+        return;
+}
+
+void UI::process_key_press(const std::string &character_pressed) {
+    for (int input_box_id : focused_input_box_ids) {
+        auto &input_box = input_boxes.at(input_box_id);
+        // We only want to do this once though.
+        if (not input_box.already_ignored_initial_character_during_active_focus) {
+            if (input_box.initial_ignore_character == character_pressed) {
+                input_box.already_ignored_initial_character_during_active_focus = true;
+                continue;
+            }
+        }
+        if (input_box.showing_placeholder) {
+            layout_input_box_contents(input_box);
+        }
+
+        for (char character : character_pressed) {
+            insert_input_box_character(input_box, input_box.caret_position, character);
+        }
+        // input_box.modified_signal.toggle_state();
+        break; // only one thing ever focused.
+    }
+}
+
+void UI::process_confirm_action() {
+    if (focused_input_box_ids.empty())
+        return;
+
+    auto &input_box = input_boxes.at(focused_input_box_ids.front());
+    if (not queue_event(UIEventType::confirmed, UIElementKind::input_box, input_box.id, -1, input_box.contents))
+        input_box.on_confirm(input_box.contents);
+
+    // after hitting enter go back to regular non focused mode.
+    focused_input_box_ids.erase(focused_input_box_ids.begin());
+    input_box.focused = false;
+    input_box.already_ignored_initial_character_during_active_focus = false;
+    set_background_color(input_box.background_ivpsc, input_box.background_color, input_box.regular_color);
+    // input_box.modified_signal.toggle_state();
+}
+
+void UI::process_delete_action() {
+    if (focused_input_box_ids.empty())
+        return;
+
+    // only one thing ever focused.
+    auto &input_box = input_boxes.at(focused_input_box_ids.front());
+    if (input_box.caret_position >= 1) {
+        if (input_box.showing_placeholder) {
+            layout_input_box_contents(input_box);
+        }
+        erase_input_box_character(input_box, input_box.caret_position - 1);
+    }
+
+    if (input_box.contents.size() == 0) {
+        show_input_box_placeholder(input_box);
+    }
+    // input_box.modified_signal.toggle_state();
+}
+
+void UI::set_input_box_caret_position(int input_box_id, size_t position) {
+    UIInputBox *input_box = get_inputbox(input_box_id);
+    if (input_box != nullptr) {
+        input_box->caret_position = std::min(position, input_box->contents.size());
+        // NOTE: scroll the caret into view, a box showing its placeholder or wrapping words has nothing to scroll
+        bool scrolls = not input_box->showing_placeholder and input_box->contents_layout.wrap != UITextWrap::words;
+        if (scrolls and not is_input_box_caret_visible(*input_box))
+            layout_input_box_contents(*input_box);
+    }
+}
+
+void UI::move_input_box_caret(int input_box_id, int offset) {
+    UIInputBox *input_box = get_inputbox(input_box_id);
+    if (input_box != nullptr) {
+        long position = static_cast<long>(input_box->caret_position) + offset;
+        set_input_box_caret_position(input_box_id, static_cast<size_t>(std::max(0L, position)));
+    }
+}
+
+int UI::add_colored_rectangle(vertex_geometry::Rectangle ndc_rectangle, const glm::vec3 &normalized_rgb) {
+
+    int element_id = ui_id_generator.get_id();
+
+    // NOTE: I don't think we need to do this because now the batcher checks to see if something has an id and if it
+    // doesn't it automatically gets one
+    int rect_id = abs_pos_object_id_generator.get_id();
+
+    auto ivp = ndc_rectangle.get_ivp();
+    draw_info::IVPColor ivpc(ivp, generate_vertex_colors(ivp.xyz_positions.size(), normalized_rgb), rect_id);
+
+    UI_LOG(info, "adding colored rectangle with element id: {} rect_id: {}", element_id, rect_id);
+
+    UIRect &rect = rectangles.emplace(element_id, ivpc, element_id);
+    rect.background_color = normalized_rgb;
+    register_for_hit_testing(UIElementKind::colored_rectangle, element_id);
+    render_list_dirty = true;
+
+    return element_id;
+}
+
+int UI::add_colored_rectangle(float x_pos_ndc, float y_pos_ndc, float width, float height,
+                              const glm::vec3 &normalized_rgb) {
+
+    int element_id = ui_id_generator.get_id();
+
+    auto is = vertex_geometry::generate_rectangle_indices();
+    auto vs = vertex_geometry::generate_rectangle_vertices(x_pos_ndc, y_pos_ndc, width, height);
+    int rect_id = abs_pos_object_id_generator.get_id();
+
+    UI_LOG(info, "adding colored rectangle with element id: {} rect_id: {}", element_id, rect_id);
+
+    std::vector<glm::vec3> cs = generate_vertex_colors(vs.size(), normalized_rgb);
+    draw_info::IVPColor ivpsc(is, vs, cs, rect_id);
+    UIRect &rect = rectangles.emplace(element_id, ivpsc, element_id);
+    rect.background_color = normalized_rgb;
+    register_for_hit_testing(UIElementKind::colored_rectangle, element_id);
+    render_list_dirty = true;
+
+    return element_id;
+}
+
+int UI::add_textbox(const std::string &text, vertex_geometry::Rectangle ndc_text_rectangle,
+                    const glm::vec3 &normalized_rgb) {
+    return this->add_textbox(text, ndc_text_rectangle.center.x, ndc_text_rectangle.center.y,
+                             ndc_text_rectangle.get_u_extent_size(), ndc_text_rectangle.get_v_extent_size(),
+                             normalized_rgb);
+}
+
+int UI::add_textbox(const std::string &text, float center_x_pos_ndc, float center_y_pos_ndc, float width, float height,
+                    const glm::vec3 &normalized_rgb) {
+
+    // this id is for grabbing an element from the UI object
+    int element_id = ui_id_generator.get_id();
+    // these are internal ones used to clean up UI elements when deleted.
+    int rect_id = abs_pos_object_id_generator.get_id();
+    int text_data_id = abs_pos_object_id_generator.get_id();
+
+    UI_LOG(info, "adding textbox with contents: {} element id: {} rect_id: {} text_data_id: {}", text,
+           element_id, rect_id, text_data_id);
+
+    // NOTE: adding rectangles so that we can check for intersection easier
+    glm::vec3 center(center_x_pos_ndc, center_y_pos_ndc, text_layer);
+    vertex_geometry::Rectangle bounding_rect(center, width, height);
+
+    UITextLayout text_layout;
+    auto text_ivp = generate_text_layout(text_layout, text, bounding_rect, text_geometry_generation_count);
+    insert_textbox(element_id, rect_id, text_data_id, bounding_rect, text_ivp, std::move(text_layout),
+                   normalized_rgb);
+
+    UI_LOG(debug, "bg id: {}", rect_id);
+    UI_LOG(debug, "text id: {}", text_data_id);
+
+    return element_id;
+};
+
+void UI::insert_textbox(int element_id, int rect_id, int text_data_id, const vertex_geometry::Rectangle &bounding_rect,
+                        const draw_info::IndexedVertexPositions &text_ivp, UITextLayout text_layout,
+                        const glm::vec3 &normalized_rgb) {
+    auto is = vertex_geometry::generate_rectangle_indices();
+    auto vs = vertex_geometry::generate_rectangle_vertices_with_z(
+        bounding_rect.center.x, bounding_rect.center.y, background_layer, bounding_rect.get_u_extent_size(),
+        bounding_rect.get_v_extent_size());
+    std::vector<glm::vec3> cs = generate_vertex_colors(vs.size(), normalized_rgb);
+    draw_info::IVPColor ivpsc(is, vs, cs, rect_id);
+
+    // TODO: do we really need this, we're already storing this in two places! that's why the below line is commented
+    // the problem is that in the renderer we will iterate over the rectangles and  textboxes elements the problem is
+    // that when we store in two places whichever one is selected last will be rendered first causing the issue because
+    // they use the same rect id
+    //    rectangles.emplace_back(ivpsc, element_id); // used here
+
+    std::vector<glm::vec3> text_cs = generate_vertex_colors(text_ivp.xyz_positions.size(), glm::vec3(1, 1, 1));
+    draw_info::IVPColor text_ivpsc(text_ivp, text_cs, text_data_id);
+
+    UITextBox &tb = text_boxes.emplace(element_id, ivpsc, text_ivpsc, bounding_rect, element_id); // used here
+    tb.text_layout = std::move(text_layout);
+    tb.background_color = normalized_rgb;
+    register_for_hit_testing(UIElementKind::textbox, element_id);
+    render_list_dirty = true;
+}
+
+std::vector<int> UI::add_textboxes(const std::vector<UITextboxDescription> &descriptions) {
+    // NOTE: ids are handed out up front and in order so that they don't depend on how the threads get scheduled
+    std::vector<int> element_ids, rect_ids, text_data_ids;
+    std::vector<vertex_geometry::Rectangle> bounding_rects;
+    for (const auto &description : descriptions) {
+        element_ids.push_back(ui_id_generator.get_id());
+        rect_ids.push_back(abs_pos_object_id_generator.get_id());
+        text_data_ids.push_back(abs_pos_object_id_generator.get_id());
+        bounding_rects.push_back(description.rect);
+        bounding_rects.back().center.z = text_layer;
+    }
+
+    UI_LOG(info, "adding {} textboxes", descriptions.size());
+
+    std::vector<draw_info::IndexedVertexPositions> text_ivps(descriptions.size());
+    std::vector<UITextLayout> text_layouts(descriptions.size());
+    std::atomic<size_t> text_generation_count{0};
+    parallel_for(descriptions.size(), [&](size_t i) {
+        size_t generation_count = 0;
+        text_ivps[i] = generate_text_layout(text_layouts[i], descriptions[i].text, bounding_rects[i], generation_count);
+        text_generation_count.fetch_add(generation_count, std::memory_order_relaxed);
+    });
+    text_geometry_generation_count += text_generation_count;
+
+    for (size_t i = 0; i < descriptions.size(); i++) {
+        insert_textbox(element_ids[i], rect_ids[i], text_data_ids[i], bounding_rects[i], text_ivps[i],
+                       std::move(text_layouts[i]), descriptions[i].color);
+    }
+    return element_ids;
+}
+
+void UI::hide_textbox(int doid) { set_hidden(doid, true); }
+
+void UI::unhide_textbox(int doid) { set_hidden(doid, false); }
+
+void UI::set_hidden(int element_id, bool hidden) {
+    if (UIContainer *container = containers.get(element_id)) {
+        if (container->hidden == hidden)
+            return;
+        container->hidden = hidden;
+        refresh_visibility_of_subtree(element_id);
+        return;
+    }
+    if (FileBrowser *fb = file_browsers.get(element_id)) {
+        for (int part_id : {fb->background_id, fb->current_directory_id, fb->file_view_id, fb->file_selection_id,
+                            fb->open_button_id, fb->close_button_id, fb->up_a_dir_button_id}) {
+            set_hidden(part_id, hidden);
+        }
+        return;
+    }
+
+    auto element = find_element(element_id);
+    if (not element or *element->hidden == hidden)
+        return;
+    *element->hidden = hidden;
+    refresh_visibility(element_id);
+}
+
+std::optional<UI::ElementReference> UI::find_element(int element_id) {
+    if (UIRect *cr = rectangles.get(element_id))
+        return ElementReference{UIElementKind::colored_rectangle, &cr->bounding_rect, &cr->hidden};
+    if (UITextBox *tb = text_boxes.get(element_id))
+        return ElementReference{UIElementKind::textbox, &tb->bounding_rect, &tb->hidden};
+    if (UIClickableTextBox *ctb = clickable_text_boxes.get(element_id))
+        return ElementReference{UIElementKind::clickable_textbox, &ctb->rect, &ctb->hidden};
+    if (UIInputBox *ib = input_boxes.get(element_id))
+        return ElementReference{UIElementKind::input_box, &ib->rect, &ib->hidden};
+    if (UIDropdown *dd = dropdowns.get(element_id))
+        return ElementReference{UIElementKind::dropdown, &dd->dropdown_rect, &dd->hidden};
+    if (UIScrollList *sl = scroll_lists.get(element_id))
+        return ElementReference{UIElementKind::scroll_list_row, &sl->rect, &sl->hidden};
+    if (UILog *log = logs.get(element_id))
+        return ElementReference{UIElementKind::log, &log->rect, &log->hidden};
+    return std::nullopt;
+}
+
+int UI::container_of(int element_id) const {
+    if (element_id < 0 or element_id >= static_cast<int>(container_of_element.size()))
+        return -1;
+    return container_of_element[element_id];
+}
+
+static bool is_rectangle_on_screen(const vertex_geometry::Rectangle &rect) {
+    return std::abs(rect.center.x) - rect.get_u_extent_size() / 2 <= 1 and
+           std::abs(rect.center.y) - rect.get_v_extent_size() / 2 <= 1;
+}
+
+bool UI::should_be_shown(int element_id) {
+    auto element = find_element(element_id);
+    if (not element or *element->hidden)
+        return false;
+    for (int container_id = container_of(element_id); container_id != -1; container_id = container_of(container_id)) {
+        if (containers.at(container_id).hidden)
+            return false;
+    }
+    return is_rectangle_on_screen(*element->rect);
+}
+
+void UI::refresh_visibility(int element_id) {
+    auto element = find_element(element_id);
+    if (not element or should_be_shown(element_id) == is_shown(element_id))
+        return;
+
+    if (is_shown(element_id)) {
+        unregister_from_hit_testing(element->kind, element_id);
+        // NOTE: something that can't be seen can't be interacted with either
+        if (UIInputBox *ib = input_boxes.get(element_id); ib and ib->focused)
+            unfocus_input_box(*ib);
+        if (UIDropdown *dd = dropdowns.get(element_id); dd and dd->dropdown_open)
+            set_dropdown_open(*dd, false);
+    } else {
+        register_for_hit_testing(element->kind, element_id);
+    }
+}
+
+void UI::refresh_visibility_of_subtree(int element_id) {
+    if (UIContainer *container = containers.get(element_id)) {
+        for (const auto &child : container->children)
+            refresh_visibility_of_subtree(child.id);
+    } else {
+        refresh_visibility(element_id);
+    }
+}
+
+void UI::modify_text_of_a_textbox(int doid, std::string new_text) {
+    // NOTE: we re-use the drawing data id to avoid a ivp leak, else we'd have to delete and regenerate which we
+    // won't do.
+    if (UITextBox *textbox = text_boxes.get(doid)) {
+        write_text_layout(textbox->text_layout, std::move(new_text), textbox->bounding_rect,
+                          textbox->text_drawing_ivpsc);
+    } else if (UIClickableTextBox *ctb = clickable_text_boxes.get(doid)) {
+        write_text_layout(ctb->text_layout, std::move(new_text), ctb->rect, ctb->text_drawing_ivpsc);
+    }
+}
+
+void UI::set_text_wrap(int element_id, UITextWrap wrap, float line_height) {
+    if (wrap == UITextWrap::words and line_height <= 0)
+        throw std::invalid_argument("wrapping words requires a positive line height");
+
+    auto set_wrap = [&](UITextLayout &layout) {
+        layout.wrap = wrap;
+        layout.line_height = line_height;
+    };
+    if (UITextBox *textbox = text_boxes.get(element_id)) {
+        set_wrap(textbox->text_layout);
+        redo_text_layout(textbox->text_layout, textbox->bounding_rect, textbox->text_drawing_ivpsc);
+    } else if (UIClickableTextBox *ctb = clickable_text_boxes.get(element_id)) {
+        set_wrap(ctb->text_layout);
+        redo_text_layout(ctb->text_layout, ctb->rect, ctb->text_drawing_ivpsc);
+    } else if (UIInputBox *ib = input_boxes.get(element_id)) {
+        set_wrap(ib->placeholder_layout);
+        set_wrap(ib->contents_layout);
+        if (ib->showing_placeholder) {
+            show_input_box_placeholder(*ib);
+        } else {
+            layout_input_box_contents(*ib);
+        }
+    }
+}
+
+void UI::modify_colored_rectangle(int doid, vertex_geometry::Rectangle ndc_rectangle) {
     // Find the textbox with the given ID
     UIRect *colored_rectangle = get_colored_rectangle(doid);
 
-    if (colored_rectangle != nullptr) {
-        // Modify the text mesh with the new text
+    if (colored_rectangle != nullptr) {
+        // Modify the text mesh with the new text
+
+        unregister_from_hit_testing(UIElementKind::colored_rectangle, doid);
+
+        // indices don't have to change
+        colored_rectangle->ivpsc.xyz_positions = ndc_rectangle.get_ivp().xyz_positions;
+        colored_rectangle->bounding_rect = compute_bounding_rectangle(colored_rectangle->ivpsc.xyz_positions);
+        // NOTE: it may have moved on or off screen
+        register_for_hit_testing(UIElementKind::colored_rectangle, doid);
+        // NOTE: the rectangle may have moved to another layer
+        render_list_dirty = true;
+        background_quads_dirty = true;
+        modified_buffers.mark(colored_rectangle->ivpsc, UIBufferAttribute::positions,
+                              {0, colored_rectangle->ivpsc.xyz_positions.size()});
+        // colored_rectangle->modified_signal.toggle_state();
+    }
+}
+
+void UI::modify_background_color(int doid, const glm::vec3 &color) {
+    if (UIRect *colored_rectangle = rectangles.get(doid)) {
+        set_background_color(colored_rectangle->ivpsc, colored_rectangle->background_color, color);
+    }
+    if (UITextBox *textbox = text_boxes.get(doid)) {
+        set_background_color(textbox->background_ivpsc, textbox->background_color, color);
+    }
+}
+
+void UI::queue_modify_text_of_a_textbox(int doid, std::string new_text) {
+    UICommand command{UICommandType::set_text, doid};
+    command.text = std::move(new_text);
+    command_queue.push(std::move(command));
+}
+
+void UI::queue_set_textbox_hidden(int doid, bool hidden) {
+    UICommand command{UICommandType::set_hidden, doid};
+    command.hidden = hidden;
+    command_queue.push(std::move(command));
+}
+
+void UI::queue_modify_colored_rectangle(int doid, vertex_geometry::Rectangle ndc_rectangle) {
+    UICommand command{UICommandType::set_rectangle, doid};
+    command.rectangle = ndc_rectangle;
+    command_queue.push(std::move(command));
+}
+
+void UI::queue_modify_background_color(int doid, const glm::vec3 &color) {
+    UICommand command{UICommandType::set_background_color, doid};
+    command.color = color;
+    command_queue.push(std::move(command));
+}
+
+void UI::apply_queued_commands() {
+    command_batch.clear();
+    command_queue.drain_newest_first([&](UICommand &command) {
+        if (command.id >= 0)
+            command_batch.push_back(std::move(command));
+    });
+
+    // NOTE: sorting by element and type with ties broken by position groups the commands of each kind of change to an
+    // element together with the newest first, so only the first of each group is applied and the rest are stale
+    command_batch_order.resize(command_batch.size());
+    std::iota(command_batch_order.begin(), command_batch_order.end(), 0);
+    std::sort(command_batch_order.begin(), command_batch_order.end(), [&](uint32_t a, uint32_t b) {
+        return std::tie(command_batch[a].id, command_batch[a].type, a) <
+               std::tie(command_batch[b].id, command_batch[b].type, b);
+    });
+
+    for (size_t i = 0; i < command_batch_order.size(); i++) {
+        UICommand &command = command_batch[command_batch_order[i]];
+        if (i > 0) {
+            const UICommand &previous = command_batch[command_batch_order[i - 1]];
+            if (previous.id == command.id and previous.type == command.type)
+                continue;
+        }
+
+        switch (command.type) {
+        case UICommandType::set_text:
+            modify_text_of_a_textbox(command.id, std::move(command.text));
+            break;
+        case UICommandType::set_hidden:
+            // NOTE: the element may have been removed after the command was queued
+            if (text_boxes.contains(command.id)) {
+                command.hidden ? hide_textbox(command.id) : unhide_textbox(command.id);
+            }
+            break;
+        case UICommandType::set_rectangle:
+            modify_colored_rectangle(command.id, command.rectangle);
+            break;
+        case UICommandType::set_background_color:
+            modify_background_color(command.id, command.color);
+            break;
+        }
+    }
+}
+
+UITextBox *UI::get_textbox(int doid) { return text_boxes.get(doid); }
+
+UIInputBox *UI::get_inputbox(int doid) { return input_boxes.get(doid); }
+
+UIRect *UI::get_colored_rectangle(int doid) { return rectangles.get(doid); }
+
+UIDropdown *UI::get_dropdown(int doid) { return dropdowns.get(doid); }
+
+UIScrollList *UI::get_scroll_list(int doid) { return scroll_lists.get(doid); }
+
+int UI::add_scroll_list(std::function<void(size_t, const std::string &)> on_click,
+                        std::function<void(size_t, const std::string &)> on_hover,
+                        const vertex_geometry::Rectangle &rect, float row_height, const glm::vec3 &regular_color,
+                        const glm::vec3 &hover_color, std::vector<std::string> items) {
+    // NOTE: written so that a nan is rejected as well
+    if (not(row_height > 0))
+        throw std::invalid_argument("a scroll list needs a positive row height");
+
+    int element_id = ui_id_generator.get_id();
+
+    float width = rect.get_u_extent_size();
+    float top = rect.center.y + rect.get_v_extent_size() / 2;
+    // NOTE: a little slack so that a row height which is an exact fraction of the height isn't lost to rounding
+    size_t row_count = std::max(1, static_cast<int>(rect.get_v_extent_size() / row_height + 1e-3f));
+
+    UI_LOG(info, "adding scroll list with {} items and {} rows element id: {}", items.size(), row_count,
+           element_id);
+
+    // NOTE: this is the only place where row drawing data is created, from here on scrolling re-uses it
+    std::vector<UITextBox> rows;
+    rows.reserve(row_count);
+    for (size_t i = 0; i < row_count; i++) {
+        int rect_id = abs_pos_object_id_generator.get_id();
+        int text_data_id = abs_pos_object_id_generator.get_id();
+
+        glm::vec3 center(rect.center.x, top - row_height * (i + 0.5f), text_layer);
+        vertex_geometry::Rectangle row_rect(center, width, row_height);
+
+        auto is = vertex_geometry::generate_rectangle_indices();
+        auto vs = vertex_geometry::generate_rectangle_vertices_with_z(center.x, center.y, background_layer, width,
+                                                                      row_height);
+        draw_info::IVPColor background_ivpsc(is, vs, generate_vertex_colors(vs.size(), regular_color), rect_id);
+
+        bool has_item = i < items.size();
+        draw_info::IVPColor text_ivpsc =
+            generate_text_ivpsc(has_item ? items[i] : "", row_rect, text_data_id, uses_per_vertex_colors(),
+                                text_geometry_generation_count);
+
+        UITextBox &row = rows.emplace_back(background_ivpsc, text_ivpsc, row_rect, element_id);
+        row.background_color = regular_color;
+        row.hidden = not has_item;
+    }
+
+    scroll_lists.emplace(element_id, std::move(on_click), std::move(on_hover), std::move(items), regular_color,
+                         hover_color, rect, row_height, std::move(rows), element_id);
+    register_for_hit_testing(UIElementKind::scroll_list_row, element_id);
+    render_list_dirty = true;
+
+    return element_id;
+}
+
+void UI::update_scroll_list_row(UIScrollList &sl, size_t row) {
+    auto &tb = sl.rows[row];
+    long item = sl.item_index_of_row(row);
+    bool hidden = item < 0;
+    if (hidden != tb.hidden) {
+        tb.hidden = hidden;
+        render_list_dirty = true;
+        uint32_t slot = hit_test_table.find({UIElementKind::scroll_list_row, sl.id, static_cast<int>(row)});
+        if (slot != UIHitTestTable::no_slot)
+            hit_test_table.set_flag(slot, UIHitTestTable::inactive_flag, hidden);
+    }
+    if (hidden)
+        return;
+
+    TextGeometryCache::get_shared().write_text_geometry(sl.items[item], tb.bounding_rect, tb.text_drawing_ivpsc,
+                                                        uses_per_vertex_colors(), &text_geometry_generation_count);
+    modified_buffers.mark_everything(tb.text_drawing_ivpsc);
+}
+
+void UI::recycle_scroll_list_row(UIScrollList &sl, size_t destination_row, size_t source_row) {
+    auto &destination = sl.rows[destination_row];
+    auto &source = sl.rows[source_row];
+    if (source.hidden or destination.hidden) {
+        update_scroll_list_row(sl, destination_row);
+        return;
+    }
+
+    // NOTE: the buffer ids stay with the rows, only the contents move, which is just swapping pointers
+    std::swap(destination.text_drawing_ivpsc.xyz_positions, source.text_drawing_ivpsc.xyz_positions);
+    std::swap(destination.text_drawing_ivpsc.indices, source.text_drawing_ivpsc.indices);
+    std::swap(destination.text_drawing_ivpsc.rgb_colors, source.text_drawing_ivpsc.rgb_colors);
+
+    float y_offset = destination.bounding_rect.center.y - source.bounding_rect.center.y;
+    for (auto &position : destination.text_drawing_ivpsc.xyz_positions) {
+        position.y += y_offset;
+    }
+    modified_buffers.mark_everything(destination.text_drawing_ivpsc);
+}
+
+UILog *UI::get_log(int doid) { return logs.get(doid); }
 
-        // indices don't have to change
-        colored_rectangle->ivpsc.xyz_positions = ndc_rectangle.get_ivp().xyz_positions;
-        colored_rectangle->ivpsc.buffer_modification_tracker.just_modified();
-        // colored_rectangle->modified_signal.toggle_state();
+/**
+ * @brief the row at the bottom of a log, which is where the text of every one of its lines is generated
+ */
+static vertex_geometry::Rectangle get_log_bottom_row(const UILog &log, float text_layer) {
+    float bottom = log.rect.center.y - log.rect.get_v_extent_size() / 2;
+    glm::vec3 center(log.rect.center.x, bottom + log.line_height / 2, text_layer);
+    return vertex_geometry::Rectangle(center, log.rect.get_u_extent_size(), log.line_height);
+}
+
+int UI::add_log(const vertex_geometry::Rectangle &rect, size_t capacity, const glm::vec3 &background_color) {
+    if (capacity == 0)
+        throw std::invalid_argument("a log needs room for at least one line");
+
+    int element_id = ui_id_generator.get_id();
+    UI_LOG(info, "adding log with {} lines element id: {}", capacity, element_id);
+
+    auto is = vertex_geometry::generate_rectangle_indices();
+    auto vs = vertex_geometry::generate_rectangle_vertices_with_z(rect.center.x, rect.center.y, background_layer,
+                                                                  rect.get_u_extent_size(), rect.get_v_extent_size());
+    draw_info::IVPColor background_ivpsc(is, vs, generate_vertex_colors(vs.size(), background_color),
+                                         abs_pos_object_id_generator.get_id());
+
+    // NOTE: this is the only place where line drawing data is created, appending re-uses it
+    std::vector<UILogLine> lines(capacity);
+    for (auto &line : lines) {
+        line.text_drawing_ivpsc = generate_text_ivpsc("", rect, abs_pos_object_id_generator.get_id(),
+                                                      uses_per_vertex_colors(), text_geometry_generation_count);
+    }
+
+    logs.emplace(element_id, std::move(background_ivpsc), background_color, rect,
+                 rect.get_v_extent_size() / capacity, std::move(lines), element_id);
+    register_for_hit_testing(UIElementKind::log, element_id);
+    render_list_dirty = true;
+
+    return element_id;
+}
+
+void UI::append_log_line(int log_id, std::string line) {
+    auto &log = logs.at(log_id);
+    auto &slot = log.lines[log.appended_line_count % log.get_capacity()];
+    slot.text = std::move(line);
+    slot.line_number = log.appended_line_count++;
+
+    // NOTE: every other line keeps its geometry, it's drawn one row further up since its offset grew by a line
+    TextGeometryCache::get_shared().write_text_geometry(slot.text, get_log_bottom_row(log, text_layer),
+                                                        slot.text_drawing_ivpsc, uses_per_vertex_colors(),
+                                                        &text_geometry_generation_count);
+    modified_buffers.mark_everything(slot.text_drawing_ivpsc);
+}
+
+void UI::clear_log(int log_id) {
+    auto &log = logs.at(log_id);
+    for (size_t slot = 0; slot < log.get_capacity() and log.is_slot_used(slot); slot++) {
+        auto &line = log.lines[slot];
+        line.text.clear();
+        line.text_drawing_ivpsc.xyz_positions.clear();
+        line.text_drawing_ivpsc.indices.clear();
+        line.text_drawing_ivpsc.rgb_colors.clear();
+        modified_buffers.mark_everything(line.text_drawing_ivpsc);
+    }
+    log.appended_line_count = 0;
+}
+
+void UI::mark_hovered_scroll_list_row_changed(UIScrollList &sl) {
+    sl.hovered_row_changed = std::any_of(hovered_entries.begin(), hovered_entries.end(), [&](const UISpatialEntry &e) {
+        return e.kind == UIElementKind::scroll_list_row and e.id == sl.id;
+    });
+}
+
+void UI::set_scroll_list_items(int scroll_list_id, std::vector<std::string> items) {
+    auto &sl = scroll_lists.at(scroll_list_id);
+    sl.items = std::move(items);
+    sl.unapplied_scroll = 0;
+    mark_hovered_scroll_list_row_changed(sl);
+
+    size_t row_count = sl.rows.size();
+    size_t last_first_visible_item = sl.items.size() > row_count ? sl.items.size() - row_count : 0;
+    sl.first_visible_item = std::min(sl.first_visible_item, last_first_visible_item);
+    for (size_t row = 0; row < row_count; row++) {
+        update_scroll_list_row(sl, row);
+    }
+}
+
+void UI::scroll_list_to(int scroll_list_id, size_t first_visible_item) {
+    auto &sl = scroll_lists.at(scroll_list_id);
+    size_t row_count = sl.rows.size();
+    size_t last_first_visible_item = sl.items.size() > row_count ? sl.items.size() - row_count : 0;
+    first_visible_item = std::min(first_visible_item, last_first_visible_item);
+    if (first_visible_item == sl.first_visible_item)
+        return;
+
+    bool scrolling_down = first_visible_item > sl.first_visible_item;
+    size_t shift = scrolling_down ? first_visible_item - sl.first_visible_item
+                                  : sl.first_visible_item - first_visible_item;
+    sl.first_visible_item = first_visible_item;
+    mark_hovered_scroll_list_row_changed(sl);
+
+    // NOTE: rows that show an item which was already visible take over the geometry of the row that showed it, only
+    // the rows showing newly visible items have to generate any text
+    size_t recycled_count = shift < row_count ? row_count - shift : 0;
+    if (scrolling_down) {
+        for (size_t row = 0; row < recycled_count; row++) {
+            recycle_scroll_list_row(sl, row, row + shift);
+        }
+        for (size_t row = recycled_count; row < row_count; row++) {
+            update_scroll_list_row(sl, row);
+        }
+    } else {
+        for (size_t row = row_count; row-- > row_count - recycled_count;) {
+            recycle_scroll_list_row(sl, row, row - shift);
+        }
+        for (size_t row = 0; row < row_count - recycled_count; row++) {
+            update_scroll_list_row(sl, row);
+        }
+    }
+}
+
+void UI::append_scroll_list_items(int scroll_list_id, std::vector<std::string> items) {
+    auto &sl = scroll_lists.at(scroll_list_id);
+    size_t previous_item_count = sl.items.size();
+    sl.items.insert(sl.items.end(), std::make_move_iterator(items.begin()), std::make_move_iterator(items.end()));
+
+    // NOTE: only the rows which were past the end of the items can show something new
+    for (size_t row = 0; row < sl.rows.size(); row++) {
+        if (sl.first_visible_item + row >= previous_item_count)
+            update_scroll_list_row(sl, row);
+    }
+}
+
+void UI::scroll_list_by(int scroll_list_id, long row_offset) {
+    long first_visible_item = static_cast<long>(scroll_lists.at(scroll_list_id).first_visible_item) + row_offset;
+    scroll_list_to(scroll_list_id, static_cast<size_t>(std::max(0L, first_visible_item)));
+}
+
+int UI::add_dropdown(std::function<void()> on_click, std::function<void()> on_hover, int dropdown_option_idx,
+                     const vertex_geometry::Rectangle &rect, const glm::vec3 &regular_color,
+                     const glm::vec3 &hover_color, const std::vector<std::string> &options,
+                     std::function<void(const std::string &)> option_on_click,
+                     std::function<void(const std::string &)> option_on_hover,
+                     const glm::vec3 &option_color, const glm::vec3 &option_hover_color) {
+
+    // this id is for grabbing an element from the UI object
+    int element_id = ui_id_generator.get_id();
+    // these are internal ones used to clean up UI elements when deleted.
+    int rect_id = abs_pos_object_id_generator.get_id();
+    int text_data_id = abs_pos_object_id_generator.get_id();
+
+    std::string text = options[dropdown_option_idx];
+
+    UI_LOG(info, "adding main dropdown with contents: {} element id: {} rect id: {} text_data_id: {}", text,
+           element_id, rect_id, text_data_id);
+
+    vertex_geometry::Rectangle layered_rect = rect;
+    layered_rect.center.z = background_layer;
+
+    // main dropdown button
+    auto ivs = layered_rect.get_ivp();
+    auto is = ivs.indices;
+    auto vs = ivs.xyz_positions;
+
+    std::vector<glm::vec3> cs = generate_vertex_colors(vs.size(), regular_color);
+    draw_info::IVPColor ivpsc(is, vs, cs, rect_id);
+
+    vertex_geometry::Rectangle text_rect = rect;
+    text_rect.center.z = text_layer;
+
+    draw_info::IVPColor text_ivpsc = generate_text_ivpsc(text, text_rect, text_data_id, uses_per_vertex_colors(),
+                                                         text_geometry_generation_count);
+
+    // NOTE: generating the text of each option is what takes time with a lot of options, so do it all in parallel
+    std::vector<draw_info::IndexedVertexPositions> option_text_ivps(options.size());
+    std::atomic<size_t> option_text_generation_count{0};
+    parallel_for(options.size(), [&](size_t j) {
+        vertex_geometry::Rectangle option_text_rect = slide_rectangle(rect, 0, -static_cast<int>(j + 1));
+        option_text_rect.center.z = dropdown_text_layer;
+        size_t generation_count = 0;
+        option_text_ivps[j] =
+            TextGeometryCache::get_shared().get_text_geometry(options[j], option_text_rect, &generation_count);
+        option_text_generation_count.fetch_add(generation_count, std::memory_order_relaxed);
+    });
+    text_geometry_generation_count += option_text_generation_count;
+
+    // now the dropdown buttons themselves
+    std::vector<draw_info::IVPColor> option_background_rect_data;
+    std::vector<vertex_geometry::Rectangle> dropdown_option_rects; // used for mouse click checking
+
+    std::vector<UIDropdownOption> ui_dropdown_options; // used for mouse click checking
+    int i = 1;
+
+    for (const auto &option : options) {
+
+        vertex_geometry::Rectangle option_rect = slide_rectangle(rect, 0, -i);
+
+        option_rect.center.z = dropdown_background_layer;
+
+        dropdown_option_rects.push_back(option_rect);
+
+        int rect_id = abs_pos_object_id_generator.get_id();
+        int text_data_id = abs_pos_object_id_generator.get_id();
+
+        UI_LOG(debug, "adding dropdown option with contents: {} rect_id: {} text_data_id: {}", option, rect_id,
+               text_data_id);
+
+        auto ivs = option_rect.get_ivp();
+        auto is = ivs.indices;
+        auto vs = ivs.xyz_positions;
+
+        glm::vec3 dropdown_background_color, dropdown_hover_background_color;
+        if (option_color == glm::vec3(0)) {
+            dropdown_background_color = regular_color * 0.75f;
+        } else {
+            dropdown_background_color = option_color;
+        }
+
+        if (option_hover_color == glm::vec3(0)) {
+            dropdown_hover_background_color = hover_color * 0.75f;
+        } else {
+            dropdown_hover_background_color = option_hover_color;
+        }
+
+        std::vector<glm::vec3> cs = generate_vertex_colors(vs.size(), dropdown_background_color);
+        draw_info::IVPColor ivpsc(is, vs, cs, rect_id);
+        option_background_rect_data.push_back(ivpsc);
+
+        option_rect.center.z = dropdown_text_layer;
+
+        const auto &option_text_ivp = option_text_ivps[i - 1];
+        draw_info::IVPColor text_ivpsc(
+            option_text_ivp, generate_vertex_colors(option_text_ivp.xyz_positions.size(), glm::vec3(1, 1, 1)),
+            text_data_id);
+
+        ui_dropdown_options.emplace_back(option, dropdown_background_color, dropdown_hover_background_color, ivpsc,
+                                         text_ivpsc, option_rect);
+
+        i += 1;
+    }
+
+    dropdowns.emplace(element_id, std::move(on_click), std::move(on_hover), ivpsc, text_ivpsc, regular_color,
+                      hover_color, rect, std::move(ui_dropdown_options), std::move(option_on_click),
+                      std::move(option_on_hover), element_id);
+    register_for_hit_testing(UIElementKind::dropdown, element_id);
+    render_list_dirty = true;
+
+    return element_id;
+}
+
+int UI::add_clickable_textbox(std::function<void()> on_click, std::function<void()> on_hover, const std::string &text,
+                              const vertex_geometry::Rectangle &rect, const glm::vec3 &regular_color,
+                              const glm::vec3 &hover_color) {
+    return this->add_clickable_textbox(on_click, on_hover, text, rect.center.x, rect.center.y, rect.get_u_extent_size(),
+                                       rect.get_v_extent_size(), regular_color, hover_color);
+}
+
+UIClickableTextBox *UI::get_clickable_textbox(int do_id) { return clickable_text_boxes.get(do_id); }
+
+bool UI::remove_colored_rectangle(int do_id) {
+    if (not rectangles.contains(do_id)) {
+        return false;
+    }
+
+    unregister_from_hit_testing(UIElementKind::colored_rectangle, do_id);
+
+    render_list_dirty = true;
+    modified_buffers.forget(rectangles.at(do_id).ivpsc.id);
+    rectangles.erase(do_id);
+    reclaim_element_id(do_id);
+    return true;
+}
+
+bool UI::remove_clickable_textbox(int do_id) {
+    // TODO: don't we have to reclaim sometrhing here or else memory leak in the batcher class
+    if (not clickable_text_boxes.contains(do_id)) {
+        return false; // Object not found
+    }
+
+    unregister_from_hit_testing(UIElementKind::clickable_textbox, do_id);
+
+    render_list_dirty = true;
+    auto &clickable_text_box = clickable_text_boxes.at(do_id);
+    modified_buffers.forget(clickable_text_box.ivpsc.id);
+    modified_buffers.forget(clickable_text_box.text_drawing_ivpsc.id);
+    clickable_text_boxes.erase(do_id);
+    reclaim_element_id(do_id);
+    return true; // Object was found and removed
+}
+
+bool UI::remove_input_box(int do_id) {
+    if (not input_boxes.contains(do_id)) {
+        return false;
+    }
+
+    // NOTE: a removed input box is not confirmed, it just disappears
+    focused_input_box_ids.erase(std::remove(focused_input_box_ids.begin(), focused_input_box_ids.end(), do_id),
+                                focused_input_box_ids.end());
+    unregister_from_hit_testing(UIElementKind::input_box, do_id);
+    render_list_dirty = true;
+    auto &input_box = input_boxes.at(do_id);
+    modified_buffers.forget(input_box.background_ivpsc.id);
+    modified_buffers.forget(input_box.text_drawing_ivpsc.id);
+    input_boxes.erase(do_id);
+    reclaim_element_id(do_id);
+    return true;
+}
+
+bool UI::remove_dropdown(int do_id) {
+    if (not dropdowns.contains(do_id)) {
+        return false;
+    }
+
+    open_dropdown_ids.erase(std::remove(open_dropdown_ids.begin(), open_dropdown_ids.end(), do_id),
+                            open_dropdown_ids.end());
+    unregister_from_hit_testing(UIElementKind::dropdown, do_id);
+    render_list_dirty = true;
+    auto &dropdown = dropdowns.at(do_id);
+    modified_buffers.forget(dropdown.dropdown_background.id);
+    modified_buffers.forget(dropdown.dropdown_text_ivpsc.id);
+    for (const auto &option : dropdown.ui_dropdown_options) {
+        modified_buffers.forget(option.background_ivpsc.id);
+        modified_buffers.forget(option.text_ivpsc.id);
+    }
+    dropdowns.erase(do_id);
+    reclaim_element_id(do_id);
+    return true;
+}
+
+bool UI::remove_file_browser(int do_id) {
+    if (not file_browsers.contains(do_id)) {
+        return false;
+    }
+
+    auto &fb = file_browsers.at(do_id);
+    remove_colored_rectangle(fb.background_id);
+    remove_textbox(fb.current_directory_id);
+    remove_textbox(fb.file_selection_id);
+    remove_scroll_list(fb.file_view_id);
+    remove_clickable_textbox(fb.open_button_id);
+    remove_clickable_textbox(fb.close_button_id);
+    remove_clickable_textbox(fb.up_a_dir_button_id);
+    file_browsers.erase(do_id);
+    reclaim_element_id(do_id);
+    return true;
+}
+
+bool UI::remove_scroll_list(int do_id) {
+    if (not scroll_lists.contains(do_id)) {
+        return false;
+    }
+
+    unregister_from_hit_testing(UIElementKind::scroll_list_row, do_id);
+    render_list_dirty = true;
+    for (const auto &row : scroll_lists.at(do_id).rows) {
+        modified_buffers.forget(row.background_ivpsc.id);
+        modified_buffers.forget(row.text_drawing_ivpsc.id);
+    }
+    scroll_lists.erase(do_id);
+    reclaim_element_id(do_id);
+    return true;
+}
+
+bool UI::remove_log(int do_id) {
+    if (not logs.contains(do_id)) {
+        return false;
+    }
+
+    unregister_from_hit_testing(UIElementKind::log, do_id);
+    render_list_dirty = true;
+    auto &log = logs.at(do_id);
+    modified_buffers.forget(log.background_ivpsc.id);
+    for (const auto &line : log.lines) {
+        modified_buffers.forget(line.text_drawing_ivpsc.id);
+    }
+    logs.erase(do_id);
+    reclaim_element_id(do_id);
+    return true;
+}
+
+bool UI::remove_textbox(int do_id) {
+    UI_LOG_SECTION("remove textbox");
+
+    bool removed = false;
+
+    if (text_boxes.contains(do_id)) {
+        unregister_from_hit_testing(UIElementKind::textbox, do_id);
+        render_list_dirty = true;
+        auto &text_box = text_boxes.at(do_id);
+        modified_buffers.forget(text_box.background_ivpsc.id);
+        modified_buffers.forget(text_box.text_drawing_ivpsc.id);
+        text_boxes.erase(do_id);
+        removed = true;
+    }
+
+    if (rectangles.contains(do_id)) {
+        unregister_from_hit_testing(UIElementKind::colored_rectangle, do_id);
+        render_list_dirty = true;
+        modified_buffers.forget(rectangles.at(do_id).ivpsc.id);
+        rectangles.erase(do_id);
+        removed = true;
+    }
+
+    // NOTE: only once we know it existed, reclaiming an id twice would let two elements share it
+    if (removed)
+        reclaim_element_id(do_id);
+    return removed;
+}
+
+int UI::add_clickable_textbox(std::function<void()> on_click, std::function<void()> on_hover, const std::string &text,
+                              float x_pos_ndc, float y_pos_ndc, float width, float height,
+                              const glm::vec3 &regular_color, const glm::vec3 &hover_color) {
+
+    // this id is for grabbing an element from the UI object
+    int element_id = ui_id_generator.get_id();
+    // these are internal ones used to clean up UI elements when deleted.
+    int rect_id = abs_pos_object_id_generator.get_id();
+    int text_data_id = abs_pos_object_id_generator.get_id();
+
+    UI_LOG(info, "adding clickable textbox with text: {} element id: {} rect id: {} text data id: {}", text,
+           element_id, rect_id, text_data_id);
+
+    vertex_geometry::Rectangle rect(glm::vec3(x_pos_ndc, y_pos_ndc, text_layer), width, height);
+    UITextLayout text_layout;
+    auto text_ivp = generate_text_layout(text_layout, text, rect, text_geometry_generation_count);
+    insert_clickable_textbox(element_id, rect_id, text_data_id, std::move(on_click), std::move(on_hover), rect,
+                             text_ivp, std::move(text_layout), regular_color, hover_color);
+    return element_id;
+};
+
+void UI::insert_clickable_textbox(int element_id, int rect_id, int text_data_id, std::function<void()> on_click,
+                                  std::function<void()> on_hover, const vertex_geometry::Rectangle &rect,
+                                  const draw_info::IndexedVertexPositions &text_ivp, UITextLayout text_layout,
+                                  const glm::vec3 &regular_color, const glm::vec3 &hover_color) {
+    auto is = vertex_geometry::generate_rectangle_indices();
+    auto vs = vertex_geometry::generate_rectangle_vertices_with_z(rect.center.x, rect.center.y, background_layer,
+                                                                  rect.get_u_extent_size(), rect.get_v_extent_size());
+    std::vector<glm::vec3> cs = generate_vertex_colors(vs.size(), regular_color);
+    draw_info::IVPColor ivpsc(is, vs, cs, rect_id);
+
+    std::vector<glm::vec3> text_cs = generate_vertex_colors(text_ivp.xyz_positions.size(), glm::vec3(1, 1, 1));
+    draw_info::IVPColor text_ivpsc(text_ivp, text_cs, text_data_id);
+
+    UIClickableTextBox &ctb = clickable_text_boxes.emplace(element_id, std::move(on_click), std::move(on_hover), ivpsc,
+                                                           text_ivpsc, regular_color, hover_color, rect, element_id);
+    ctb.text_layout = std::move(text_layout);
+    register_for_hit_testing(UIElementKind::clickable_textbox, element_id);
+    render_list_dirty = true;
+}
+
+std::vector<int> UI::add_clickable_textboxes(const std::vector<UIClickableTextboxDescription> &descriptions) {
+    // NOTE: ids are handed out up front and in order so that they don't depend on how the threads get scheduled
+    std::vector<int> element_ids, rect_ids, text_data_ids;
+    std::vector<vertex_geometry::Rectangle> rects;
+    for (const auto &description : descriptions) {
+        element_ids.push_back(ui_id_generator.get_id());
+        rect_ids.push_back(abs_pos_object_id_generator.get_id());
+        text_data_ids.push_back(abs_pos_object_id_generator.get_id());
+        rects.push_back(description.rect);
+        rects.back().center.z = text_layer;
+    }
+
+    UI_LOG(info, "adding {} clickable textboxes", descriptions.size());
+
+    std::vector<draw_info::IndexedVertexPositions> text_ivps(descriptions.size());
+    std::vector<UITextLayout> text_layouts(descriptions.size());
+    std::atomic<size_t> text_generation_count{0};
+    parallel_for(descriptions.size(), [&](size_t i) {
+        size_t generation_count = 0;
+        text_ivps[i] = generate_text_layout(text_layouts[i], descriptions[i].text, rects[i], generation_count);
+        text_generation_count.fetch_add(generation_count, std::memory_order_relaxed);
+    });
+    text_geometry_generation_count += text_generation_count;
+
+    for (size_t i = 0; i < descriptions.size(); i++) {
+        const auto &description = descriptions[i];
+        insert_clickable_textbox(element_ids[i], rect_ids[i], text_data_ids[i], description.on_click,
+                                 description.on_hover, rects[i], text_ivps[i], std::move(text_layouts[i]),
+                                 description.regular_color, description.hover_color);
+    }
+    return element_ids;
+}
+
+int UI::add_input_box(std::function<void(const std::string &)> on_confirm, const std::string &placeholder_text,
+                      const vertex_geometry::Rectangle &ndc_rect, const glm::vec3 &regular_color,
+                      const glm::vec3 &focused_color, std::optional<std::string> initial_ignore_character) {
+    return this->add_input_box(on_confirm, placeholder_text, ndc_rect.center.x, ndc_rect.center.y,
+                               ndc_rect.get_u_extent_size(), ndc_rect.get_v_extent_size(), regular_color, focused_color,
+                               initial_ignore_character);
+}
+
+int UI::add_input_box(std::function<void(const std::string &)> on_confirm, const std::string &placeholder_text,
+                      float x_pos_ndc, float y_pos_ndc, float width, float height, const glm::vec3 &regular_color,
+                      const glm::vec3 &focused_color, std::optional<std::string> initial_ignore_character) {
+
+    // this id is for grabbing an element from the UI object
+    int element_id = ui_id_generator.get_id();
+    // these are internal ones used to clean up UI elements when deleted.
+    int rect_id = abs_pos_object_id_generator.get_id();
+    int text_data_id = abs_pos_object_id_generator.get_id();
+
+    UI_LOG(info, "adding input box with placeholder text: {} element id: {}, rect id: {} text data id: {}",
+           placeholder_text, element_id, rect_id, text_data_id);
+
+    vertex_geometry::Rectangle rect(glm::vec3(x_pos_ndc, y_pos_ndc, text_layer), width, height);
+    UITextLayout placeholder_layout;
+    auto text_ivp = generate_text_layout(placeholder_layout, placeholder_text, rect, text_geometry_generation_count);
+    insert_input_box(element_id, rect_id, text_data_id, std::move(on_confirm), placeholder_text, rect, text_ivp,
+                     std::move(placeholder_layout), regular_color, focused_color, std::move(initial_ignore_character));
+    return element_id;
+};
+
+void UI::insert_input_box(int element_id, int rect_id, int text_data_id,
+                          std::function<void(const std::string &)> on_confirm, const std::string &placeholder_text,
+                          const vertex_geometry::Rectangle &rect, const draw_info::IndexedVertexPositions &text_ivp,
+                          UITextLayout placeholder_layout, const glm::vec3 &regular_color,
+                          const glm::vec3 &focused_color, std::optional<std::string> initial_ignore_character) {
+    auto is = vertex_geometry::generate_rectangle_indices();
+    auto vs = vertex_geometry::generate_rectangle_vertices_with_z(rect.center.x, rect.center.y, background_layer,
+                                                                  rect.get_u_extent_size(), rect.get_v_extent_size());
+    std::vector<glm::vec3> cs = generate_vertex_colors(vs.size(), regular_color);
+    draw_info::IVPColor ivpsc(is, vs, cs, rect_id);
+
+    std::vector<glm::vec3> text_cs = generate_vertex_colors(text_ivp.xyz_positions.size(), glm::vec3(1, 1, 1));
+    draw_info::IVPColor text_ivpsc(text_ivp, text_cs, text_data_id);
+
+    UIInputBox &ib = input_boxes.emplace(element_id, std::move(on_confirm), ivpsc, text_ivpsc, placeholder_text, "",
+                                         regular_color, focused_color, rect, element_id,
+                                         std::move(initial_ignore_character));
+    ib.placeholder_layout = std::move(placeholder_layout);
+    ib.contents_layout.wrap = ib.placeholder_layout.wrap;
+    ib.contents_layout.line_height = ib.placeholder_layout.line_height;
+    register_for_hit_testing(UIElementKind::input_box, element_id);
+    render_list_dirty = true;
+}
+
+void UI::register_for_hit_testing(UIElementKind kind, int id) {
+    // NOTE: hidden and off screen elements are left out entirely, which is what makes them free while processing input
+    if (not should_be_shown(id))
+        return;
+    if (id >= static_cast<int>(element_shown.size()))
+        element_shown.resize(id + 1, false);
+    element_shown[id] = true;
+    render_list_dirty = true;
+
+    UISpatialEntry entry{kind, id};
+    switch (kind) {
+    case UIElementKind::colored_rectangle:
+        entry.order = rectangles.insertion_order_of(id);
+        break;
+    case UIElementKind::textbox:
+        entry.order = text_boxes.insertion_order_of(id);
+        break;
+    case UIElementKind::clickable_textbox:
+        entry.order = clickable_text_boxes.insertion_order_of(id);
+        break;
+    case UIElementKind::input_box:
+        entry.order = input_boxes.insertion_order_of(id);
+        break;
+    case UIElementKind::log:
+        entry.order = logs.insertion_order_of(id);
+        break;
+    case UIElementKind::dropdown:
+    case UIElementKind::dropdown_option:
+        // NOTE: options are registered along with their dropdown
+        entry.order = dropdowns.insertion_order_of(id);
+        break;
+    case UIElementKind::scroll_list_row: {
+        // NOTE: a scroll list is only ever hit through its rows, which never move
+        entry.order = scroll_lists.insertion_order_of(id);
+        auto &rows = scroll_lists.at(id).rows;
+        for (int i = 0; i < static_cast<int>(rows.size()); i++) {
+            uint8_t flags = rows[i].hidden ? UIHitTestTable::inactive_flag : 0;
+            spatial_grid.insert(hit_test_table.add({UIElementKind::scroll_list_row, id, i, entry.order},
+                                                   rows[i].bounding_rect, flags),
+                                rows[i].bounding_rect);
+        }
+        return;
+    }
+    }
+
+    const auto &rect = get_entry_rectangle(entry);
+    spatial_grid.insert(hit_test_table.add(entry, rect), rect);
+
+    if (entry.kind == UIElementKind::dropdown) {
+        auto &dd = dropdowns.at(id);
+        uint8_t flags = dd.dropdown_open ? 0 : UIHitTestTable::inactive_flag;
+        for (int i = 0; i < static_cast<int>(dd.ui_dropdown_options.size()); i++) {
+            const auto &option_rect = dd.ui_dropdown_options[i].rect;
+            spatial_grid.insert(
+                hit_test_table.add({UIElementKind::dropdown_option, id, i, entry.order}, option_rect, flags),
+                option_rect);
+        }
+    }
+}
+
+void UI::unregister_hit_slot(const UISpatialEntry &entry, const vertex_geometry::Rectangle &rect) {
+    uint32_t slot = hit_test_table.find(entry);
+    if (slot == UIHitTestTable::no_slot)
+        return;
+    spatial_grid.remove(slot, rect);
+    hit_test_table.remove(slot);
+}
+
+void UI::unregister_from_hit_testing(UIElementKind kind, int id) {
+    auto is_being_removed = [&](const UISpatialEntry &entry) {
+        bool same_kind = entry.kind == kind or
+                         (kind == UIElementKind::dropdown and entry.kind == UIElementKind::dropdown_option);
+        return same_kind and entry.id == id;
+    };
+    // NOTE: un-hovered first so that the element doesn't stay hovered, if it's registered again while under the mouse
+    // it's hovered again by the next process_mouse_position
+    for (const auto &entry : hovered_entries) {
+        if (is_being_removed(entry))
+            set_entry_hovered(entry, false);
+    }
+    hovered_entries.erase(std::remove_if(hovered_entries.begin(), hovered_entries.end(), is_being_removed),
+                          hovered_entries.end());
+
+    if (not is_shown(id))
+        return;
+    element_shown[id] = false;
+    render_list_dirty = true;
+
+    if (kind == UIElementKind::scroll_list_row) {
+        auto &rows = scroll_lists.at(id).rows;
+        for (int i = 0; i < static_cast<int>(rows.size()); i++) {
+            unregister_hit_slot({UIElementKind::scroll_list_row, id, i}, rows[i].bounding_rect);
+        }
+        return;
+    }
+
+    UISpatialEntry entry{kind, id};
+    unregister_hit_slot(entry, get_entry_rectangle(entry));
+
+    if (kind == UIElementKind::dropdown) {
+        auto &options = dropdowns.at(id).ui_dropdown_options;
+        for (int i = 0; i < static_cast<int>(options.size()); i++) {
+            unregister_hit_slot({UIElementKind::dropdown_option, id, i}, options[i].rect);
+        }
     }
 }
 
-UITextBox *UI::get_textbox(int doid) {
-    auto it = std::find_if(text_boxes.begin(), text_boxes.end(),
-                           [doid](const UITextBox &obj) { return obj.parent_ui_id == doid; });
+std::vector<UIClickableTextBox> &UI::get_clickable_text_boxes() { return clickable_text_boxes.get_elements(); }
+std::vector<UIDropdown> &UI::get_dropdowns() { return dropdowns.get_elements(); }
+std::vector<UIInputBox> &UI::get_input_boxes() { return input_boxes.get_elements(); }
+std::vector<UITextBox> &UI::get_text_boxes() { return text_boxes.get_elements(); }
+std::vector<UIRect> &UI::get_colored_boxes() { return rectangles.get_elements(); }
+std::vector<UIScrollList> &UI::get_scroll_lists() { return scroll_lists.get_elements(); }
+std::vector<UILog> &UI::get_logs() { return logs.get_elements(); }
+
+FileBrowser *UI::get_file_browser(int doid) { return file_browsers.get(doid); }
+
+UIContainer *UI::get_container(int doid) { return containers.get(doid); }
 
-    if (it != text_boxes.end()) {
-        return &(*it);
-    }
-    return nullptr;
+int UI::add_container(const vertex_geometry::Rectangle &rect, const UILayoutParameters &parameters) {
+    int element_id = ui_id_generator.get_id();
+    UI_LOG(info, "adding container with element id: {}", element_id);
+    containers.emplace(element_id, parameters, rect, element_id);
+    return element_id;
 }
 
-UIInputBox *UI::get_inputbox(int doid) {
-    auto it =
-        std::find_if(input_boxes.begin(), input_boxes.end(), [doid](const UIInputBox &obj) { return obj.id == doid; });
+int UI::add_child_container(int parent_container_id, const UILayoutParameters &parameters, float weight) {
+    int element_id = add_container(vertex_geometry::Rectangle(glm::vec3(0), 0, 0), parameters);
+    add_to_container(parent_container_id, element_id, weight);
+    return element_id;
+}
 
-    if (it != input_boxes.end()) {
-        return &(*it);
-    }
-    return nullptr;
+void UI::mark_layout_dirty(UIContainer &container) {
+    if (container.layout_dirty)
+        return;
+    container.layout_dirty = true;
+    dirty_container_ids.push_back(container.id);
 }
 
-UIRect *UI::get_colored_rectangle(int doid) {
-    auto it = std::find_if(rectangles.begin(), rectangles.end(),
-                           [doid](const UIRect &obj) { return obj.parent_ui_id == doid; });
-    if (it != rectangles.end()) {
-        return &(*it);
+void UI::add_to_container(int container_id, int element_id, float weight) {
+    auto &container = containers.at(container_id);
+    // NOTE: its parts are separate elements with rectangles of their own, neither placing nor hiding would reach them
+    if (file_browsers.contains(element_id))
+        throw std::invalid_argument("file browser " + std::to_string(element_id) + " can't be put into a container");
+    bool is_container = containers.contains(element_id);
+    if (is_container) {
+        for (int ancestor = container_id; ancestor != -1;) {
+            if (ancestor == element_id)
+                throw std::invalid_argument("container " + std::to_string(element_id) + " can't be inside of itself");
+            ancestor = container_of(ancestor);
+        }
     }
-    return nullptr;
-}
 
-int UI::add_dropdown(std::function<void()> on_click, std::function<void()> on_hover, int dropdown_option_idx,
-                     const vertex_geometry::Rectangle &rect, const glm::vec3 &regular_color,
-                     const glm::vec3 &hover_color, const std::vector<std::string> &options,
-                     std::function<void(std::string)> option_on_click, std::function<void(std::string)> option_on_hover,
-                     const glm::vec3 &option_color, const glm::vec3 &option_hover_color) {
+    detach_from_container(element_id);
+    if (element_id >= static_cast<int>(container_of_element.size()))
+        container_of_element.resize(element_id + 1, -1);
+    container_of_element[element_id] = container_id;
 
-    // this id is for grabbing an element from the UI object
-    int element_id = ui_id_generator.get_id();
-    // these are internal ones used to clean up UI elements when deleted.
-    int rect_id = abs_pos_object_id_generator.get_id();
-    int text_data_id = abs_pos_object_id_generator.get_id();
+    container.children.push_back({element_id, is_container, weight});
+    mark_layout_dirty(container);
+    refresh_visibility_of_subtree(element_id);
+}
 
-    std::string text = options[dropdown_option_idx];
+bool UI::remove_from_container(int container_id, int element_id) {
+    if (element_id < 0 or element_id >= static_cast<int>(container_of_element.size()) or
+        container_of_element[element_id] != container_id)
+        return false;
+    detach_from_container(element_id);
+    // NOTE: it may have been hidden by the container it was in
+    refresh_visibility_of_subtree(element_id);
+    return true;
+}
 
-    global_logger->info("adding main dropdown with contents: {} element id: {} rect id: {} text_data_id: {}", text,
-                        element_id, rect_id, text_data_id);
+void UI::detach_from_container(int element_id) {
+    if (element_id < 0 or element_id >= static_cast<int>(container_of_element.size()))
+        return;
+    int container_id = container_of_element[element_id];
+    if (container_id == -1)
+        return;
+    container_of_element[element_id] = -1;
 
-    vertex_geometry::Rectangle layered_rect = rect;
-    layered_rect.center.z = background_layer;
+    auto &container = containers.at(container_id);
+    container.children.erase(std::remove_if(container.children.begin(), container.children.end(),
+                                            [&](const UIContainerChild &child) { return child.id == element_id; }),
+                             container.children.end());
+    mark_layout_dirty(container);
+}
 
-    // main dropdown button
-    auto ivs = layered_rect.get_ivp();
-    auto is = ivs.indices;
-    auto vs = ivs.xyz_positions;
+void UI::reclaim_element_id(int element_id) {
+    detach_from_container(element_id);
+    ui_id_generator.reclaim_id(element_id);
+}
 
-    std::vector<glm::vec3> cs(vs.size(), regular_color);
-    draw_info::IVPColor ivpsc(is, vs, cs, rect_id);
+void UI::set_container_rectangle(int container_id, const vertex_geometry::Rectangle &rect) {
+    auto &container = containers.at(container_id);
+    container.rect = rect;
+    mark_layout_dirty(container);
+}
 
-    vertex_geometry::Rectangle text_rect = rect;
-    text_rect.center.z = text_layer;
+void UI::set_container_layout(int container_id, const UILayoutParameters &parameters) {
+    auto &container = containers.at(container_id);
+    container.parameters = parameters;
+    mark_layout_dirty(container);
+}
 
-    draw_info::IndexedVertexPositions text_ivp = grid_font::get_text_geometry(text, text_rect);
-    std::vector<glm::vec3> text_cs(text_ivp.xyz_positions.size(), glm::vec3(1, 1, 1));
-    draw_info::IVPColor text_ivpsc(text_ivp, text_cs, text_data_id);
+bool UI::remove_container(int do_id) {
+    if (not containers.contains(do_id)) {
+        return false;
+    }
 
-    // now the dropdown buttons themselves
-    std::vector<draw_info::IVPColor> option_text_data;
-    std::vector<draw_info::IVPColor> option_background_rect_data;
-    std::vector<vertex_geometry::Rectangle> dropdown_option_rects; // used for mouse click checking
+    std::vector<UIContainerChild> children = std::move(containers.at(do_id).children);
+    containers.erase(do_id);
+    reclaim_element_id(do_id);
+    for (const auto &child : children) {
+        container_of_element[child.id] = -1;
+        // NOTE: the children may have been hidden by the container or one of the containers it was in
+        refresh_visibility_of_subtree(child.id);
+    }
+    return true;
+}
 
-    std::vector<UIDropdownOption> ui_dropdown_options; // used for mouse click checking
-    int i = 1;
+void UI::update_layout() {
+    containers_laid_out_last_update = 0;
+    if (dirty_container_ids.empty())
+        return;
 
-    for (const auto &option : options) {
+    auto depth_of = [&](int id) {
+        int depth = 0;
+        for (int parent = container_of(id); parent != -1; parent = container_of(parent))
+            depth++;
+        return depth;
+    };
+    // NOTE: parents go first, laying out a parent lays out the children it moves along with it, after which they are
+    // no longer dirty and get skipped
+    std::sort(dirty_container_ids.begin(), dirty_container_ids.end(),
+              [&](int a, int b) { return depth_of(a) < depth_of(b); });
+
+    for (int id : dirty_container_ids) {
+        UIContainer *container = containers.get(id);
+        if (container != nullptr and container->layout_dirty)
+            layout_container(*container);
+    }
+    dirty_container_ids.clear();
+}
 
-        vertex_geometry::Rectangle option_rect = slide_rectangle(rect, 0, -i);
+std::vector<vertex_geometry::Rectangle> UI::compute_layout(const UIContainer &container) const {
+    const auto &parameters = container.parameters;
+    const auto &children = container.children;
+    std::vector<vertex_geometry::Rectangle> rects;
+    if (children.empty())
+        return rects;
+    rects.reserve(children.size());
+
+    float width = std::max(0.0f, container.rect.get_u_extent_size() - 2 * parameters.padding);
+    float height = std::max(0.0f, container.rect.get_v_extent_size() - 2 * parameters.padding);
+    const glm::vec3 &center = container.rect.center;
+    float total_spacing = parameters.spacing * (children.size() - 1);
+
+    switch (parameters.layout) {
+    case UILayout::vertical_stack:
+    case UILayout::horizontal_stack: {
+        bool vertical = parameters.layout == UILayout::vertical_stack;
+        float total_weight = 0;
+        for (const auto &child : children)
+            total_weight += child.weight;
+        float available = std::max(0.0f, (vertical ? height : width) - total_spacing);
+
+        // NOTE: the edge we're laying out from, the top for vertical stacks and the left for horizontal ones
+        float edge = vertical ? center.y + height / 2 : center.x - width / 2;
+        for (const auto &child : children) {
+            float share = total_weight > 0 ? available * child.weight / total_weight : 0;
+            if (vertical) {
+                rects.emplace_back(glm::vec3(center.x, edge - share / 2, center.z), width, share);
+                edge -= share + parameters.spacing;
+            } else {
+                rects.emplace_back(glm::vec3(edge + share / 2, center.y, center.z), share, height);
+                edge += share + parameters.spacing;
+            }
+        }
+        break;
+    }
+    case UILayout::grid: {
+        int columns = std::max(1, parameters.grid_columns);
+        int rows = (static_cast<int>(children.size()) + columns - 1) / columns;
+        vertex_geometry::Rectangle inner(center, width, height);
+        vertex_geometry::Grid grid(rows, columns, inner);
+        for (size_t i = 0; i < children.size(); i++) {
+            // NOTE: the spacing is taken out of every cell, half on each side
+            vertex_geometry::Rectangle cell = grid.get_at(i % columns, i / columns);
+            rects.emplace_back(cell.center, std::max(0.0f, cell.get_u_extent_size() - parameters.spacing),
+                               std::max(0.0f, cell.get_v_extent_size() - parameters.spacing));
+        }
+        break;
+    }
+    }
+    return rects;
+}
 
-        option_rect.center.z = dropdown_background_layer;
+static bool is_same_rectangle(const vertex_geometry::Rectangle &a, const vertex_geometry::Rectangle &b) {
+    return a.center == b.center and a.get_u_extent_size() == b.get_u_extent_size() and
+           a.get_v_extent_size() == b.get_v_extent_size();
+}
 
-        dropdown_option_rects.push_back(option_rect);
+void UI::layout_container(UIContainer &container) {
+    containers_laid_out_last_update++;
+    container.layout_dirty = false;
+
+    std::vector<vertex_geometry::Rectangle> rects = compute_layout(container);
+    for (size_t i = 0; i < container.children.size(); i++) {
+        auto &child = container.children[i];
+        // NOTE: this is what keeps a change from spreading, whatever didn't move is left alone along with its subtree
+        if (child.placed and is_same_rectangle(child.rect, rects[i]))
+            continue;
+        child.rect = rects[i];
+        child.placed = true;
+
+        if (child.is_container) {
+            auto &child_container = containers.at(child.id);
+            child_container.rect = rects[i];
+            layout_container(child_container);
+        } else {
+            place_element(child.id, rects[i]);
+        }
+    }
+}
 
-        int rect_id = abs_pos_object_id_generator.get_id();
-        int text_data_id = abs_pos_object_id_generator.get_id();
+void UI::place_element(int element_id, const vertex_geometry::Rectangle &rect) {
+    auto element = find_element(element_id);
+    if (not element)
+        return;
+    UIElementKind kind = element->kind;
+    vertex_geometry::Rectangle from = *element->rect;
 
-        global_logger->info("adding dropdown option with contents: {} rect_id: {} text_data_id: {}", option, rect_id,
-                            text_data_id);
+    vertex_geometry::Rectangle to(glm::vec3(rect.center.x, rect.center.y, from.center.z), rect.get_u_extent_size(),
+                                  rect.get_v_extent_size());
+    if (is_same_rectangle(from, to))
+        return;
 
-        auto ivs = option_rect.get_ivp();
-        auto is = ivs.indices;
-        auto vs = ivs.xyz_positions;
+    // NOTE: everything belonging to the element is mapped from where the element was to where it goes, for text that
+    // is the same as generating it again since grid_font fits text to its rectangle
+    glm::vec2 scale(from.get_u_extent_size() > 0 ? to.get_u_extent_size() / from.get_u_extent_size() : 1,
+                    from.get_v_extent_size() > 0 ? to.get_v_extent_size() / from.get_v_extent_size() : 1);
+    bool resized = scale != glm::vec2(1);
+    auto remap_rectangle = [&](vertex_geometry::Rectangle &r) {
+        glm::vec3 center(to.center.x + (r.center.x - from.center.x) * scale.x,
+                         to.center.y + (r.center.y - from.center.y) * scale.y, r.center.z);
+        r = vertex_geometry::Rectangle(center, r.get_u_extent_size() * scale.x, r.get_v_extent_size() * scale.y);
+    };
+    auto remap_buffer = [&](draw_info::IVPColor &ivpsc) {
+        for (auto &position : ivpsc.xyz_positions) {
+            position.x = to.center.x + (position.x - from.center.x) * scale.x;
+            position.y = to.center.y + (position.y - from.center.y) * scale.y;
+        }
+        modified_buffers.mark(ivpsc, UIBufferAttribute::positions, {0, ivpsc.xyz_positions.size()});
+    };
 
-        glm::vec3 dropdown_background_color, dropdown_hover_background_color;
-        if (option_color == glm::vec3(0)) {
-            dropdown_background_color = regular_color * 0.75f;
+    unregister_from_hit_testing(kind, element_id);
+
+    switch (kind) {
+    case UIElementKind::colored_rectangle: {
+        auto &cr = rectangles.at(element_id);
+        remap_buffer(cr.ivpsc);
+        remap_rectangle(cr.bounding_rect);
+        break;
+    }
+    case UIElementKind::textbox: {
+        auto &tb = text_boxes.at(element_id);
+        remap_buffer(tb.background_ivpsc);
+        remap_rectangle(tb.bounding_rect);
+        // NOTE: wrapped text has a fixed line height, so a new size means breaking it into lines again
+        if (resized and tb.text_layout.wrap == UITextWrap::words) {
+            redo_text_layout(tb.text_layout, tb.bounding_rect, tb.text_drawing_ivpsc);
         } else {
-            dropdown_background_color = option_color;
+            remap_buffer(tb.text_drawing_ivpsc);
         }
-
-        if (option_hover_color == glm::vec3(0)) {
-            dropdown_hover_background_color = hover_color * 0.75f;
+        break;
+    }
+    case UIElementKind::clickable_textbox: {
+        auto &ctb = clickable_text_boxes.at(element_id);
+        remap_buffer(ctb.ivpsc);
+        remap_rectangle(ctb.rect);
+        if (resized and ctb.text_layout.wrap == UITextWrap::words) {
+            redo_text_layout(ctb.text_layout, ctb.rect, ctb.text_drawing_ivpsc);
         } else {
-            dropdown_hover_background_color = option_hover_color;
+            remap_buffer(ctb.text_drawing_ivpsc);
+        }
+        break;
+    }
+    case UIElementKind::input_box: {
+        auto &ib = input_boxes.at(element_id);
+        remap_buffer(ib.background_ivpsc);
+        remap_rectangle(ib.rect);
+        // NOTE: the spacing of the characters doesn't scale with the box, so they have to be laid out again
+        if (not resized) {
+            remap_buffer(ib.text_drawing_ivpsc);
+        } else if (ib.showing_placeholder) {
+            show_input_box_placeholder(ib);
+        } else {
+            layout_input_box_contents(ib);
+        }
+        break;
+    }
+    case UIElementKind::dropdown: {
+        auto &dd = dropdowns.at(element_id);
+        remap_buffer(dd.dropdown_background);
+        remap_buffer(dd.dropdown_text_ivpsc);
+        remap_rectangle(dd.dropdown_rect);
+        for (auto &option : dd.ui_dropdown_options) {
+            remap_buffer(option.background_ivpsc);
+            remap_buffer(option.text_ivpsc);
+            remap_rectangle(option.rect);
         }
+        break;
+    }
+    case UIElementKind::scroll_list_row: {
+        auto &sl = scroll_lists.at(element_id);
+        remap_rectangle(sl.rect);
+        sl.row_height *= scale.y;
+        for (auto &row : sl.rows) {
+            remap_buffer(row.background_ivpsc);
+            remap_buffer(row.text_drawing_ivpsc);
+            remap_rectangle(row.bounding_rect);
+        }
+        break;
+    }
+    case UIElementKind::log: {
+        // NOTE: the bottom row maps onto the new bottom row and the line offsets scale along with the line height
+        auto &log = logs.at(element_id);
+        remap_buffer(log.background_ivpsc);
+        remap_rectangle(log.rect);
+        log.line_height *= scale.y;
+        for (auto &line : log.lines) {
+            remap_buffer(line.text_drawing_ivpsc);
+        }
+        break;
+    }
+    case UIElementKind::dropdown_option:
+        break;
+    }
 
-        std::vector<glm::vec3> cs(vs.size(), dropdown_background_color);
-        draw_info::IVPColor ivpsc(is, vs, cs, rect_id);
-        option_background_rect_data.push_back(ivpsc);
+    // NOTE: it may have moved on or off screen
+    register_for_hit_testing(kind, element_id);
+    background_quads_dirty = true;
+}
 
-        option_rect.center.z = dropdown_text_layer;
+int UI::add_file_browser(std::function<void(const std::string &)> on_open, std::function<void()> on_close,
+                         const std::string &directory, float width, float height, const glm::vec3 &regular_color,
+                         const glm::vec3 &hover_color, int visible_row_count) {
+    int element_id = ui_id_generator.get_id();
+
+    UI_LOG(info, "adding file browser at directory: {} element id: {}", directory, element_id);
+
+    FileBrowser &fb = file_browsers.emplace(element_id, width, height);
+    fb.id = element_id;
+    fb.on_open = std::move(on_open);
+    fb.on_close = std::move(on_close);
+
+    // NOTE: the background goes onto the layer of the ui itself so that it's behind the backgrounds of the rest
+    vertex_geometry::Rectangle background_rect = fb.background_rect;
+    background_rect.center.z = z_layer;
+    fb.background_id = add_colored_rectangle(background_rect, regular_color * 0.5f);
+    fb.current_directory_id = add_textbox("", fb.current_directory_rect, regular_color);
+    fb.file_selection_id = add_textbox("", fb.file_selection_bar, regular_color);
+
+    // NOTE: the callbacks look the file browser up by id, since its address changes when others are removed
+    float row_height = fb.main_file_view_rect.get_v_extent_size() / visible_row_count;
+    fb.file_view_id = add_scroll_list(
+        [this, element_id](size_t item, const std::string &) { select_file_browser_entry(element_id, item); },
+        [](size_t, const std::string &) {}, fb.main_file_view_rect, row_height, regular_color, hover_color, {});
+
+    fb.open_button_id = add_clickable_textbox(
+        [this, element_id] {
+            auto &fb = file_browsers.at(element_id);
+            if (not fb.selected_file.empty()) {
+                std::string selected_file = fb.selected_file;
+                fb.on_open(selected_file);
+            }
+        },
+        [] {}, "open", fb.open_button, regular_color, hover_color);
+    fb.close_button_id = add_clickable_textbox([this, element_id] { file_browsers.at(element_id).on_close(); }, [] {},
+                                               "x", fb.close_button, regular_color, hover_color);
+    fb.up_a_dir_button_id = add_clickable_textbox(
+        [this, element_id] {
+            std::filesystem::path current_directory(file_browsers.at(element_id).current_directory);
+            set_file_browser_directory(element_id, current_directory.parent_path().string());
+        },
+        [] {}, "..", fb.up_a_dir_button, regular_color, hover_color);
+
+    set_file_browser_directory(element_id, directory);
+
+    return element_id;
+}
 
-        draw_info::IndexedVertexPositions text_ivp = grid_font::get_text_geometry(option, option_rect);
-        std::vector<glm::vec3> text_cs(text_ivp.xyz_positions.size(), glm::vec3(1, 1, 1));
-        draw_info::IVPColor text_ivpsc(text_ivp, text_cs, text_data_id);
+void UI::set_file_browser_directory(int file_browser_id, const std::string &directory) {
+    auto &fb = file_browsers.at(file_browser_id);
 
-        option_text_data.push_back(text_ivpsc);
+    // NOTE: the same directory must always end up as the same string, otherwise it would be cached more than once
+    std::error_code error;
+    std::filesystem::path path = std::filesystem::absolute(directory, error);
+    if (error) {
+        UI_LOG(warn, "file browser {} can't show {}: {}, staying in {}", file_browser_id, directory, error.message(),
+               fb.current_directory);
+        return;
+    }
+    path = path.lexically_normal();
+    if (path.has_relative_path() and not path.has_filename())
+        path = path.parent_path();
+
+    fb.current_directory = path.string();
+    fb.selected_file.clear();
+    modify_text_of_a_textbox(fb.current_directory_id, fb.current_directory);
+    modify_text_of_a_textbox(fb.file_selection_id, "");
+
+    scroll_list_to(fb.file_view_id, 0);
+    set_scroll_list_items(fb.file_view_id, {});
+    fb.shown_listing_generation = 0;
+    fb.shown_entry_count = 0;
+    // NOTE: if the directory was cached it shows up right away
+    sync_file_browser(fb);
+}
 
-        UIDropdownOption udo(option, dropdown_background_color, dropdown_hover_background_color, ivpsc, text_ivpsc,
-                             option_rect, option_on_click, option_on_hover);
+void UI::sync_file_browser(FileBrowser &fb) {
+    const auto &listing = directory_listing_cache.request(fb.current_directory);
+    bool starting_over = listing.generation != fb.shown_listing_generation;
+    if (not starting_over and listing.entries.size() == fb.shown_entry_count)
+        return;
 
-        ui_dropdown_options.push_back(udo);
+    std::vector<std::string> items;
+    items.reserve(listing.entries.size() - (starting_over ? 0 : fb.shown_entry_count));
+    for (size_t i = starting_over ? 0 : fb.shown_entry_count; i < listing.entries.size(); i++) {
+        const auto &entry = listing.entries[i];
+        items.push_back(entry.is_directory ? entry.name + "/" : entry.name);
+    }
 
-        i += 1;
+    if (starting_over) {
+        set_scroll_list_items(fb.file_view_id, std::move(items));
+    } else {
+        append_scroll_list_items(fb.file_view_id, std::move(items));
     }
+    fb.shown_listing_generation = listing.generation;
+    fb.shown_entry_count = listing.entries.size();
+}
 
-    UIDropdown dropdown(on_click, on_hover, ivpsc, text_ivpsc, regular_color, hover_color, rect, ui_dropdown_options,
-                        element_id);
+void UI::select_file_browser_entry(int file_browser_id, size_t entry_index) {
+    auto &fb = file_browsers.at(file_browser_id);
+    const auto &listing = directory_listing_cache.request(fb.current_directory);
+    if (entry_index >= listing.entries.size())
+        return;
 
-    dropdowns.emplace_back(dropdown);
-    return dropdown.id;
+    const auto &entry = listing.entries[entry_index];
+    std::string path = (std::filesystem::path(fb.current_directory) / entry.name).string();
+    if (entry.is_directory) {
+        set_file_browser_directory(file_browser_id, path);
+        return;
+    }
+    fb.selected_file = path;
+    modify_text_of_a_textbox(fb.file_selection_id, entry.name);
 }
 
-// todo we don't need to take in a reference ot a rect to make our lives easier.
-// in the future makt it take a const reference for the future.
-int UI::add_clickable_textbox(std::function<void()> on_click, std::function<void()> on_hover, const std::string &text,
-                              vertex_geometry::Rectangle &rect, const glm::vec3 &regular_color,
-                              const glm::vec3 &hover_color) {
-    return this->add_clickable_textbox(on_click, on_hover, text, rect.center.x, rect.center.y, rect.get_u_extent_size(),
-                                       rect.get_v_extent_size(), regular_color, hover_color);
+void UI::update_file_browsers() {
+    if (file_browsers.size() == 0)
+        return;
+    directory_listing_cache.poll();
+    for (auto &fb : file_browsers.get_elements()) {
+        sync_file_browser(fb);
+    }
 }
 
-UIClickableTextBox *UI::get_clickable_textbox(int do_id) {
-    auto it = std::find_if(clickable_text_boxes.begin(), clickable_text_boxes.end(),
-                           [do_id](const UIClickableTextBox &obj) { return obj.id == do_id; });
+const std::vector<UIBufferModification> &UI::get_buffer_modifications() const { return modified_buffers.get(); }
+void UI::clear_buffer_modifications() { modified_buffers.clear(); }
 
-    if (it != clickable_text_boxes.end()) {
-        return &(*it);
+const std::vector<UIDrawItem> &UI::get_render_list() {
+    if (render_list_dirty) {
+        rebuild_render_list();
     }
-    return nullptr;
+    return render_list;
 }
 
-bool UI::remove_clickable_textbox(int do_id) {
-    // TODO: don't we have to reclaim sometrhing here or else memory leak in the batcher class
-    auto it = std::find_if(clickable_text_boxes.begin(), clickable_text_boxes.end(),
-                           [do_id](const UIClickableTextBox &obj) { return obj.id == do_id; });
+void UI::finish_frame() {
+    record_buffer_modification_frames();
+    modified_buffers.clear();
+    render_list_changed = false;
+    frame_number++;
+}
 
-    if (it != clickable_text_boxes.end()) {
-        clickable_text_boxes.erase(it);
-        return true; // Object was found and removed
+void UI::record_buffer_modification_frames() {
+    for (const auto &modification : modified_buffers.get()) {
+        if (modification.buffer_id < 0)
+            continue;
+        // NOTE: a buffer that a snapshot holds no copy of gets copied the next time it's drawn regardless
+        for (auto &snapshot : render_snapshots) {
+            auto it = snapshot.buffers.find(modification.buffer_id);
+            if (it != snapshot.buffers.end())
+                it->second.modified_frame = frame_number;
+        }
     }
-    return false; // Object not found
 }
 
-bool UI::remove_textbox(int do_id) {
-    LogSection _(*global_logger, "remove textbox");
+UISnapshotElement UI::make_snapshot_element(const UIDrawItem &item, draw_info::IVPColor *&background_ivpsc,
+                                            draw_info::IVPColor *&text_ivpsc) {
+    UISnapshotElement element{item};
+    text_ivpsc = nullptr;
+    switch (item.kind) {
+    case UIElementKind::colored_rectangle: {
+        auto &cr = rectangles.at(item.id);
+        background_ivpsc = &cr.ivpsc;
+        element.background_color = cr.background_color;
+        break;
+    }
+    case UIElementKind::textbox: {
+        auto &tb = text_boxes.at(item.id);
+        background_ivpsc = &tb.background_ivpsc;
+        text_ivpsc = &tb.text_drawing_ivpsc;
+        element.background_color = tb.background_color;
+        element.text_color = tb.text_color;
+        break;
+    }
+    case UIElementKind::clickable_textbox: {
+        auto &cr = clickable_text_boxes.at(item.id);
+        background_ivpsc = &cr.ivpsc;
+        text_ivpsc = &cr.text_drawing_ivpsc;
+        element.background_color = cr.background_color;
+        element.text_color = cr.text_color;
+        break;
+    }
+    case UIElementKind::input_box: {
+        auto &ib = input_boxes.at(item.id);
+        background_ivpsc = &ib.background_ivpsc;
+        text_ivpsc = &ib.text_drawing_ivpsc;
+        element.background_color = ib.background_color;
+        element.text_color = ib.text_color;
+        break;
+    }
+    case UIElementKind::dropdown: {
+        auto &dd = dropdowns.at(item.id);
+        background_ivpsc = &dd.dropdown_background;
+        text_ivpsc = &dd.dropdown_text_ivpsc;
+        element.background_color = dd.background_color;
+        element.text_color = dd.text_color;
+        break;
+    }
+    case UIElementKind::dropdown_option: {
+        auto &udo = dropdowns.at(item.id).ui_dropdown_options[item.option_index];
+        background_ivpsc = &udo.background_ivpsc;
+        text_ivpsc = &udo.text_ivpsc;
+        element.background_color = udo.background_color;
+        element.text_color = udo.text_color;
+        break;
+    }
+    case UIElementKind::scroll_list_row: {
+        auto &row = scroll_lists.at(item.id).rows[item.option_index];
+        background_ivpsc = &row.background_ivpsc;
+        text_ivpsc = &row.text_drawing_ivpsc;
+        element.background_color = row.background_color;
+        element.text_color = row.text_color;
+        break;
+    }
+    case UIElementKind::log: {
+        // NOTE: the lines become elements of their own, see publish_render_snapshot
+        auto &log = logs.at(item.id);
+        background_ivpsc = &log.background_ivpsc;
+        element.background_color = log.background_color;
+        element.text_color = log.text_color;
+        break;
+    }
+    }
+    element.background_buffer_id = background_ivpsc->id;
+    element.text_buffer_id = text_ivpsc ? text_ivpsc->id : -1;
+    return element;
+}
 
-    ui_id_generator.reclaim_id(do_id);
+void UI::publish_render_snapshot() {
+    record_buffer_modification_frames();
+
+    UIRenderSnapshot &snapshot = render_snapshots[written_snapshot_index];
+    // NOTE: compared against when this snapshot last copied the buffer rather than when it was last published, since
+    // it may have been published many times without the buffer while it was hidden
+    auto copy_if_stale = [&](const draw_info::IVPColor *ivpsc) {
+        if (ivpsc == nullptr or ivpsc->id < 0)
+            return;
+        auto [it, never_copied] = snapshot.buffers.try_emplace(ivpsc->id);
+        auto &buffer = it->second;
+        if (never_copied or buffer.modified_frame >= buffer.copied_frame) {
+            buffer.ivpsc = *ivpsc;
+            buffer.copied_frame = frame_number;
+        }
+        buffer.published_frame = frame_number;
+    };
+
+    snapshot.elements.clear();
+    for (const auto &item : get_render_list()) {
+        draw_info::IVPColor *background_ivpsc, *text_ivpsc;
+        snapshot.elements.push_back(make_snapshot_element(item, background_ivpsc, text_ivpsc));
+        copy_if_stale(background_ivpsc);
+        copy_if_stale(text_ivpsc);
+
+        if (item.kind != UIElementKind::log)
+            continue;
+        auto &log = logs.at(item.id);
+        UISnapshotElement line_element = snapshot.elements.back();
+        line_element.background_buffer_id = -1;
+        for (size_t slot = 0; slot < log.get_capacity() and log.is_slot_used(slot); slot++) {
+            auto &line = log.lines[slot];
+            line_element.item.option_index = static_cast<int>(slot);
+            line_element.text_buffer_id = line.text_drawing_ivpsc.id;
+            line_element.text_offset = log.get_line_offset(slot);
+            snapshot.elements.push_back(line_element);
+            copy_if_stale(&line.text_drawing_ivpsc);
+        }
+    }
+    snapshot.frame = frame_number;
+
+    // NOTE: hidden and removed elements lose their copy, one that is shown again is simply copied anew
+    for (auto it = snapshot.buffers.begin(); it != snapshot.buffers.end();) {
+        if (it->second.published_frame != frame_number)
+            it = snapshot.buffers.erase(it);
+        else
+            ++it;
+    }
 
-    auto text_it = std::find_if(text_boxes.begin(), text_boxes.end(),
-                                [do_id](const UITextBox &obj) { return obj.parent_ui_id == do_id; });
+    written_snapshot_index =
+        latest_snapshot_index.exchange(written_snapshot_index | new_snapshot_flag, std::memory_order_acq_rel) &
+        snapshot_index_mask;
+}
 
-    auto rect_it = std::find_if(rectangles.begin(), rectangles.end(),
-                                [do_id](const UIRect &rect) { return rect.parent_ui_id == do_id; });
+const UIRenderSnapshot &UI::acquire_render_snapshot() {
+    if (latest_snapshot_index.load(std::memory_order_acquire) & new_snapshot_flag) {
+        read_snapshot_index =
+            latest_snapshot_index.exchange(read_snapshot_index, std::memory_order_acq_rel) & snapshot_index_mask;
+    }
+    return render_snapshots[read_snapshot_index];
+}
 
-    bool removed = false;
+void UI::rebuild_render_list() {
+    render_list.clear();
+
+    // NOTE: hidden and off screen elements are never part of the render list
+    for (size_t i = 0; i < rectangles.size(); i++) {
+        const auto &rect = rectangles.get_elements()[i];
+        int id = rectangles.id_at(i);
+        if (not is_shown(id))
+            continue;
+        // NOTE: rectangles are usually made at a z of 0 rather than on the ui's layer, so they're drawn with the other
+        // backgrounds as they always were, a rectangle only gets its own place when it was put further back than that
+        float z = std::max(rect.bounding_rect.center.z, background_layer);
+        render_list.push_back({UIElementKind::colored_rectangle, id, -1, z, rectangles.insertion_order_of(id)});
+    }
+    for (size_t i = 0; i < text_boxes.size(); i++) {
+        int id = text_boxes.id_at(i);
+        if (is_shown(id))
+            render_list.push_back(
+                {UIElementKind::textbox, id, -1, background_layer, text_boxes.insertion_order_of(id)});
+    }
+    for (size_t i = 0; i < clickable_text_boxes.size(); i++) {
+        int id = clickable_text_boxes.id_at(i);
+        if (not is_shown(id))
+            continue;
+        render_list.push_back(
+            {UIElementKind::clickable_textbox, id, -1, background_layer, clickable_text_boxes.insertion_order_of(id)});
+    }
+    for (size_t i = 0; i < input_boxes.size(); i++) {
+        int id = input_boxes.id_at(i);
+        if (not is_shown(id))
+            continue;
+        render_list.push_back({UIElementKind::input_box, id, -1, background_layer, input_boxes.insertion_order_of(id)});
+    }
+    for (size_t i = 0; i < dropdowns.size(); i++) {
+        const auto &dd = dropdowns.get_elements()[i];
+        int id = dropdowns.id_at(i);
+        if (not is_shown(id))
+            continue;
+        unsigned int order = dropdowns.insertion_order_of(id);
+        render_list.push_back({UIElementKind::dropdown, id, -1, background_layer, order});
+        if (not dd.dropdown_open)
+            continue;
+        for (size_t j = 0; j < dd.ui_dropdown_options.size(); j++) {
+            render_list.push_back(
+                {UIElementKind::dropdown_option, id, static_cast<int>(j), dropdown_background_layer, order});
+        }
+    }
+    for (size_t i = 0; i < scroll_lists.size(); i++) {
+        const auto &sl = scroll_lists.get_elements()[i];
+        int id = scroll_lists.id_at(i);
+        if (not is_shown(id))
+            continue;
+        unsigned int order = scroll_lists.insertion_order_of(id);
+        for (size_t j = 0; j < sl.rows.size(); j++) {
+            if (not sl.rows[j].hidden)
+                render_list.push_back(
+                    {UIElementKind::scroll_list_row, id, static_cast<int>(j), background_layer, order});
+        }
+    }
+    for (size_t i = 0; i < logs.size(); i++) {
+        int id = logs.id_at(i);
+        if (is_shown(id))
+            render_list.push_back({UIElementKind::log, id, -1, background_layer, logs.insertion_order_of(id)});
+    }
 
-    if (text_it != text_boxes.end()) {
-        text_boxes.erase(text_it);
-        removed = true;
+    // NOTE: a larger z is further away, so it gets drawn first
+    // NOTE: no two items compare equal (the same element never shows up twice), so this gives the same order a stable
+    // sort would, without the scratch buffer std::stable_sort allocates whenever the list is rebuilt
+    std::sort(render_list.begin(), render_list.end(), [](const UIDrawItem &a, const UIDrawItem &b) {
+        if (a.z != b.z)
+            return a.z > b.z;
+        if (a.kind != b.kind)
+            return a.kind < b.kind;
+        if (a.order != b.order)
+            return a.order < b.order;
+        return a.option_index < b.option_index;
+    });
+
+    render_list_dirty = false;
+    render_list_changed = true;
+    background_quads_dirty = true;
+}
+
+const std::vector<UIQuadInstance> &UI::get_background_quads() {
+    if (render_list_dirty) {
+        rebuild_render_list();
     }
+    if (background_quads_dirty) {
+        rebuild_background_quads();
+    }
+    return background_quads;
+}
 
-    if (rect_it != rectangles.end()) {
-        rectangles.erase(rect_it);
-        removed = true;
+void UI::rebuild_background_quads() {
+    background_quads.clear();
+    background_quads.reserve(render_list.size());
+    for (const auto &item : render_list) {
+        UISpatialEntry entry{item.kind, item.id, item.option_index};
+        const auto &rect = get_entry_rectangle(entry);
+        // NOTE: the draw order of a rectangle isn't always its z, see rebuild_render_list, the quad keeps the real one
+        float z = item.kind == UIElementKind::colored_rectangle ? rect.center.z : item.z;
+        background_quads.push_back({glm::vec2(rect.center.x, rect.center.y), z,
+                                    glm::vec2(rect.get_u_extent_size(), rect.get_v_extent_size()),
+                                    get_entry_background_color(entry)});
     }
+    background_quads_dirty = false;
+}
 
-    return removed;
+/**
+ * @brief the layout of a UILayoutFile
+ *
+ * the header is followed by the elements, then the positions (three floats each) and indices of all the text geometry,
+ * then the names and texts of every element back to back. Offsets into the positions, indices and strings are counted
+ * in positions, indices and bytes respectively.
+ */
+struct UILayoutFileHeader {
+    char magic[4];
+    uint32_t version;
+    float z_layer;
+    uint32_t element_count;
+    uint32_t position_count;
+    uint32_t index_count;
+    uint32_t string_byte_count;
+};
+
+struct UILayoutFileElement {
+    uint32_t kind;
+    uint32_t name_offset, name_size;
+    uint32_t text_offset, text_size;
+    uint32_t wrap;
+    float line_height;
+    float rect[5];
+    float colors[6];
+    uint32_t first_position, position_count;
+    uint32_t first_index, index_count;
+};
+
+static constexpr char ui_layout_file_magic[4] = {'U', 'I', 'L', 'Y'};
+static constexpr uint32_t ui_layout_file_version = 3;
+
+static size_t get_layout_file_byte_count(const UILayoutFileHeader &header) {
+    return sizeof(UILayoutFileHeader) + header.element_count * sizeof(UILayoutFileElement) +
+           header.position_count * sizeof(glm::vec3) + header.index_count * sizeof(uint32_t) +
+           header.string_byte_count;
 }
 
-int UI::add_clickable_textbox(std::function<void()> on_click, std::function<void()> on_hover, const std::string &text,
-                              float x_pos_ndc, float y_pos_ndc, float width, float height,
-                              const glm::vec3 &regular_color, const glm::vec3 &hover_color) {
+UILayoutFile::UILayoutFile(const std::string &path) {
+#if defined(__linux__) || defined(__APPLE__)
+    int file_descriptor = open(path.c_str(), O_RDONLY);
+    if (file_descriptor == -1)
+        throw std::runtime_error("couldn't open layout file " + path);
+    struct stat file_status;
+    if (fstat(file_descriptor, &file_status) == 0 and file_status.st_size > 0) {
+        byte_count = static_cast<size_t>(file_status.st_size);
+        void *mapping = mmap(nullptr, byte_count, PROT_READ, MAP_PRIVATE, file_descriptor, 0);
+        if (mapping != MAP_FAILED) {
+            data = static_cast<const char *>(mapping);
+            mapped = true;
+        }
+    }
+    close(file_descriptor);
+    if (not mapped)
+        throw std::runtime_error("couldn't map layout file " + path);
+#else
+    std::ifstream file(path, std::ios::binary);
+    if (not file)
+        throw std::runtime_error("couldn't open layout file " + path);
+    read_bytes.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+    data = read_bytes.data();
+    byte_count = read_bytes.size();
+#endif
+
+    // NOTE: everything is validated here once, so that get_element can trust the offsets
+    UILayoutFileHeader header;
+    if (byte_count < sizeof(header))
+        throw std::runtime_error(path + " is too small to be a layout file");
+    std::memcpy(&header, data, sizeof(header));
+    if (std::memcmp(header.magic, ui_layout_file_magic, sizeof(header.magic)) != 0 or
+        header.version != ui_layout_file_version or get_layout_file_byte_count(header) != byte_count)
+        throw std::runtime_error(path + " isn't a layout file of version " + std::to_string(ui_layout_file_version));
+
+    const auto *elements = reinterpret_cast<const UILayoutFileElement *>(data + sizeof(header));
+    for (size_t i = 0; i < header.element_count; i++) {
+        const auto &element = elements[i];
+        bool in_bounds = element.kind <= static_cast<uint32_t>(UIElementKind::input_box) and
+                         element.wrap <= static_cast<uint32_t>(UITextWrap::words) and
+                         uint64_t(element.name_offset) + element.name_size <= header.string_byte_count and
+                         uint64_t(element.text_offset) + element.text_size <= header.string_byte_count and
+                         uint64_t(element.first_position) + element.position_count <= header.position_count and
+                         uint64_t(element.first_index) + element.index_count <= header.index_count;
+        if (not in_bounds)
+            throw std::runtime_error("element " + std::to_string(i) + " of " + path + " is out of bounds");
+
+        // NOTE: the indices of an element count from its first position, loading hands them to the ui as they are
+        const auto *indices = reinterpret_cast<const uint32_t *>(data + sizeof(header) +
+                                                                 header.element_count * sizeof(UILayoutFileElement) +
+                                                                 header.position_count * sizeof(glm::vec3)) +
+                              element.first_index;
+        for (size_t j = 0; j < element.index_count; j++) {
+            if (indices[j] >= element.position_count)
+                throw std::runtime_error("element " + std::to_string(i) + " of " + path +
+                                         " has an index past its positions");
+        }
+    }
+    element_count = header.element_count;
+}
 
-    // this id is for grabbing an element from the UI object
-    int element_id = ui_id_generator.get_id();
-    // these are internal ones used to clean up UI elements when deleted.
-    int rect_id = abs_pos_object_id_generator.get_id();
-    int text_data_id = abs_pos_object_id_generator.get_id();
+UILayoutFile::~UILayoutFile() {
+#if defined(__linux__) || defined(__APPLE__)
+    if (mapped)
+        munmap(const_cast<char *>(data), byte_count);
+#endif
+}
 
-    global_logger->info("adding clickable textbox with text: {} element id: {} rect id: {} text data id: {}", text,
-                        element_id, rect_id, text_data_id);
+float UILayoutFile::get_z_layer() const { return reinterpret_cast<const UILayoutFileHeader *>(data)->z_layer; }
+
+UILayoutElement UILayoutFile::get_element(size_t index) const {
+    const auto &header = *reinterpret_cast<const UILayoutFileHeader *>(data);
+    const char *elements_start = data + sizeof(UILayoutFileHeader);
+    const char *positions_start = elements_start + header.element_count * sizeof(UILayoutFileElement);
+    const char *indices_start = positions_start + header.position_count * sizeof(glm::vec3);
+    const char *strings_start = indices_start + header.index_count * sizeof(uint32_t);
+
+    const auto &element = reinterpret_cast<const UILayoutFileElement *>(elements_start)[index];
+    const float *r = element.rect;
+    const float *c = element.colors;
+    return {static_cast<UIElementKind>(element.kind),
+            std::string_view(strings_start + element.name_offset, element.name_size),
+            std::string_view(strings_start + element.text_offset, element.text_size),
+            static_cast<UITextWrap>(element.wrap),
+            element.line_height,
+            vertex_geometry::Rectangle(glm::vec3(r[0], r[1], r[2]), r[3], r[4]),
+            {glm::vec3(c[0], c[1], c[2]), glm::vec3(c[3], c[4], c[5])},
+            {reinterpret_cast<const glm::vec3 *>(positions_start) + element.first_position, element.position_count,
+             reinterpret_cast<const unsigned int *>(indices_start) + element.first_index, element.index_count}};
+}
 
-    auto is = vertex_geometry::generate_rectangle_indices();
-    auto vs =
-        vertex_geometry::generate_rectangle_vertices_with_z(x_pos_ndc, y_pos_ndc, background_layer, width, height);
-    std::vector<glm::vec3> cs(vs.size(), regular_color);
+void UI::save_layout(const std::string &path, const std::unordered_map<int, std::string> &names) {
+    std::vector<UILayoutFileElement> elements;
+    std::vector<glm::vec3> positions;
+    std::vector<uint32_t> indices;
+    std::string strings;
+
+    auto add_element = [&](UIElementKind kind, int id, const vertex_geometry::Rectangle &rect,
+                           const glm::vec3 &color, const glm::vec3 &second_color,
+                           const std::vector<glm::vec3> &text_positions,
+                           const std::vector<unsigned int> &text_indices, const UITextLayout &text_layout = {}) {
+        UILayoutFileElement element{};
+        element.kind = static_cast<uint32_t>(kind);
+        element.wrap = static_cast<uint32_t>(text_layout.wrap);
+        element.line_height = text_layout.line_height;
+        const std::string &text = text_layout.text;
+        auto name = names.find(id);
+        if (name != names.end()) {
+            element.name_offset = strings.size();
+            element.name_size = name->second.size();
+            strings += name->second;
+        }
+        element.text_offset = strings.size();
+        element.text_size = text.size();
+        strings += text;
+
+        float rect_values[5] = {rect.center.x, rect.center.y, rect.center.z, rect.get_u_extent_size(),
+                                rect.get_v_extent_size()};
+        std::memcpy(element.rect, rect_values, sizeof(rect_values));
+        float color_values[6] = {color.x, color.y, color.z, second_color.x, second_color.y, second_color.z};
+        std::memcpy(element.colors, color_values, sizeof(color_values));
+
+        element.first_position = positions.size();
+        element.position_count = text_positions.size();
+        positions.insert(positions.end(), text_positions.begin(), text_positions.end());
+        element.first_index = indices.size();
+        element.index_count = text_indices.size();
+        indices.insert(indices.end(), text_indices.begin(), text_indices.end());
+        elements.push_back(element);
+    };
+
+    // NOTE: in the order they were added so that the loaded elements get the same hit priority
+    auto ids_in_insertion_order = [](const auto &store) {
+        std::vector<int> ids(store.size());
+        for (size_t i = 0; i < store.size(); i++)
+            ids[i] = store.id_at(i);
+        std::sort(ids.begin(), ids.end(),
+                  [&](int a, int b) { return store.insertion_order_of(a) < store.insertion_order_of(b); });
+        return ids;
+    };
+
+    for (int id : ids_in_insertion_order(rectangles)) {
+        const auto &cr = rectangles.at(id);
+        add_element(UIElementKind::colored_rectangle, id, cr.bounding_rect, cr.background_color, cr.background_color,
+                    {}, {});
+    }
+    for (int id : ids_in_insertion_order(text_boxes)) {
+        const auto &tb = text_boxes.at(id);
+        add_element(UIElementKind::textbox, id, tb.bounding_rect, tb.background_color, tb.background_color,
+                    tb.text_drawing_ivpsc.xyz_positions, tb.text_drawing_ivpsc.indices, tb.text_layout);
+    }
+    for (int id : ids_in_insertion_order(clickable_text_boxes)) {
+        const auto &ctb = clickable_text_boxes.at(id);
+        add_element(UIElementKind::clickable_textbox, id, ctb.rect, ctb.regular_color, ctb.hover_color,
+                    ctb.text_drawing_ivpsc.xyz_positions, ctb.text_drawing_ivpsc.indices, ctb.text_layout);
+    }
+    for (int id : ids_in_insertion_order(input_boxes)) {
+        // NOTE: whatever was typed isn't part of the layout, the box is stored showing its placeholder
+        const auto &ib = input_boxes.at(id);
+        if (ib.showing_placeholder) {
+            add_element(UIElementKind::input_box, id, ib.rect, ib.regular_color, ib.focused_color,
+                        ib.text_drawing_ivpsc.xyz_positions, ib.text_drawing_ivpsc.indices, ib.placeholder_layout);
+        } else {
+            UITextLayout placeholder_layout;
+            placeholder_layout.wrap = ib.placeholder_layout.wrap;
+            placeholder_layout.line_height = ib.placeholder_layout.line_height;
+            auto placeholder_ivp = generate_text_layout(placeholder_layout, ib.placeholder_text, ib.rect,
+                                                        text_geometry_generation_count);
+            add_element(UIElementKind::input_box, id, ib.rect, ib.regular_color, ib.focused_color,
+                        placeholder_ivp.xyz_positions, placeholder_ivp.indices, placeholder_layout);
+        }
+    }
 
-    draw_info::IVPColor ivpsc(is, vs, cs, rect_id);
-    vertex_geometry::Rectangle rect(glm::vec3(x_pos_ndc, y_pos_ndc, text_layer), width, height);
+    UILayoutFileHeader header{};
+    std::memcpy(header.magic, ui_layout_file_magic, sizeof(header.magic));
+    header.version = ui_layout_file_version;
+    header.z_layer = z_layer;
+    header.element_count = elements.size();
+    header.position_count = positions.size();
+    header.index_count = indices.size();
+    header.string_byte_count = strings.size();
+
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    file.write(reinterpret_cast<const char *>(&header), sizeof(header));
+    file.write(reinterpret_cast<const char *>(elements.data()), elements.size() * sizeof(UILayoutFileElement));
+    file.write(reinterpret_cast<const char *>(positions.data()), positions.size() * sizeof(glm::vec3));
+    file.write(reinterpret_cast<const char *>(indices.data()), indices.size() * sizeof(uint32_t));
+    file.write(strings.data(), strings.size());
+    if (not file)
+        throw std::runtime_error("couldn't write layout file " + path);
+}
 
-    draw_info::IndexedVertexPositions text_ivp = grid_font::get_text_geometry(text, rect);
-    std::vector<glm::vec3> text_cs(text_ivp.xyz_positions.size(), glm::vec3(1, 1, 1));
-    draw_info::IVPColor text_ivpsc(text_ivp, text_cs, text_data_id);
+std::unordered_map<std::string, int> UI::load_layout(const UILayoutFile &layout_file) {
+    std::unordered_map<std::string, int> ids_by_name;
+    // NOTE: every layer of a ui is at the same offset from its z layer, so moving to another ui is a single offset
+    float z_offset = z_layer - layout_file.get_z_layer();
 
-    UIClickableTextBox clickable_text_box(on_click, on_hover, ivpsc, text_ivpsc, regular_color, hover_color, rect,
-                                          element_id);
-    clickable_text_boxes.emplace_back(clickable_text_box);
-    return clickable_text_box.id;
-};
+    draw_info::IndexedVertexPositions text_ivp;
+    for (size_t i = 0; i < layout_file.size(); i++) {
+        UILayoutElement element = layout_file.get_element(i);
+        vertex_geometry::Rectangle rect = element.rect;
+        rect.center.z += z_offset;
+
+        const auto &geometry = element.text_geometry;
+        text_ivp.xyz_positions.assign(geometry.xyz_positions, geometry.xyz_positions + geometry.vertex_count);
+        text_ivp.indices.assign(geometry.indices, geometry.indices + geometry.index_count);
+        if (z_offset != 0) {
+            for (auto &position : text_ivp.xyz_positions)
+                position.z += z_offset;
+        }
 
-int UI::add_input_box(std::function<void(std::string)> on_confirm, const std::string &placeholder_text,
-                      const vertex_geometry::Rectangle &ndc_rect, const glm::vec3 &regular_color,
-                      const glm::vec3 &focused_color, std::optional<std::string> initial_ignore_character) {
-    return this->add_input_box(on_confirm, placeholder_text, ndc_rect.center.x, ndc_rect.center.y,
-                               ndc_rect.get_u_extent_size(), ndc_rect.get_v_extent_size(), regular_color, focused_color,
-                               initial_ignore_character);
+        // NOTE: the lines are left empty, which makes the first change to the text lay all of it out again
+        UITextLayout text_layout;
+        text_layout.text = element.text;
+        text_layout.wrap = element.wrap;
+        text_layout.line_height = element.line_height;
+
+        int element_id;
+        switch (element.kind) {
+        case UIElementKind::colored_rectangle:
+            element_id = add_colored_rectangle(rect, element.colors[0]);
+            break;
+        case UIElementKind::textbox:
+            element_id = ui_id_generator.get_id();
+            insert_textbox(element_id, abs_pos_object_id_generator.get_id(), abs_pos_object_id_generator.get_id(),
+                           rect, text_ivp, std::move(text_layout), element.colors[0]);
+            break;
+        case UIElementKind::clickable_textbox:
+            element_id = ui_id_generator.get_id();
+            insert_clickable_textbox(element_id, abs_pos_object_id_generator.get_id(),
+                                     abs_pos_object_id_generator.get_id(), [] {}, [] {}, rect, text_ivp,
+                                     std::move(text_layout), element.colors[0], element.colors[1]);
+            break;
+        case UIElementKind::input_box:
+        default:
+            element_id = ui_id_generator.get_id();
+            insert_input_box(element_id, abs_pos_object_id_generator.get_id(), abs_pos_object_id_generator.get_id(),
+                             [](const std::string &) {}, std::string(element.text), rect, text_ivp,
+                             std::move(text_layout), element.colors[0], element.colors[1], std::nullopt);
+            break;
+        }
+
+        if (not element.name.empty())
+            ids_by_name.emplace(element.name, element_id);
+    }
+
+    UI_LOG(info, "loaded {} elements from a layout file", layout_file.size());
+    return ids_by_name;
 }
 
-int UI::add_input_box(std::function<void(std::string)> on_confirm, const std::string &placeholder_text, float x_pos_ndc,
-                      float y_pos_ndc, float width, float height, const glm::vec3 &regular_color,
-                      const glm::vec3 &focused_color, std::optional<std::string> initial_ignore_character) {
+/**
+ * @brief an element of the text form of a layout, once its line was parsed
+ */
+struct UILayoutTextElement {
+    std::string kind, name, text;
+    vertex_geometry::Rectangle rect;
+    glm::vec3 color, second_color;
+};
 
-    // this id is for grabbing an element from the UI object
-    int element_id = ui_id_generator.get_id();
-    // these are internal ones used to clean up UI elements when deleted.
-    int rect_id = abs_pos_object_id_generator.get_id();
-    int text_data_id = abs_pos_object_id_generator.get_id();
+std::unordered_map<std::string, int> UI::add_layout_text(const std::string &layout_text) {
+    // NOTE: everything is parsed before anything is added, so that a mistake on some line doesn't leave half a layout
+    std::vector<UILayoutTextElement> elements;
+    std::unordered_set<std::string> names;
+    std::istringstream lines(layout_text);
+    std::string line;
+    for (int line_number = 1; std::getline(lines, line); line_number++) {
+        std::istringstream stream(line);
+        std::string kind, name;
+        if (not(stream >> kind) or kind[0] == '#')
+            continue;
+
+        auto fail = [&](const std::string &reason) {
+            throw std::invalid_argument("line " + std::to_string(line_number) + " of the layout: " + reason);
+        };
+        float x, y, width, height;
+        glm::vec3 color, second_color;
+        stream >> name >> x >> y >> width >> height >> color.x >> color.y >> color.z;
+        bool has_second_color = kind == "clickable_textbox" or kind == "input_box";
+        if (has_second_color)
+            stream >> second_color.x >> second_color.y >> second_color.z;
+        std::string text;
+        if (kind != "rectangle")
+            stream >> std::quoted(text);
+        if (not stream)
+            fail("expected a name, a rectangle, " + std::string(has_second_color ? "two colors" : "a color") +
+                 (kind == "rectangle" ? "" : " and quoted text"));
+
+        if (kind != "rectangle" and kind != "textbox" and kind != "clickable_textbox" and kind != "input_box")
+            fail("unknown element kind " + kind);
+        if (not names.insert(name).second)
+            fail("there already is an element named " + name);
+        elements.push_back({kind, name, text, vertex_geometry::Rectangle(glm::vec3(x, y, 0), width, height), color,
+                            second_color});
+    }
 
-    global_logger->info("adding input box with placeholder text: {} element id: {}, rect id: {} text data id: {}",
-                        placeholder_text, element_id, rect_id, text_data_id);
+    std::unordered_map<std::string, int> ids_by_name;
+    for (const auto &element : elements) {
+        vertex_geometry::Rectangle rect = element.rect;
+        int element_id;
+        if (element.kind == "rectangle") {
+            element_id = add_colored_rectangle(rect.center.x, rect.center.y, rect.get_u_extent_size(),
+                                               rect.get_v_extent_size(), element.color);
+        } else if (element.kind == "textbox") {
+            element_id = add_textbox(element.text, rect, element.color);
+        } else if (element.kind == "clickable_textbox") {
+            element_id = add_clickable_textbox([] {}, [] {}, element.text, rect, element.color, element.second_color);
+        } else {
+            element_id = add_input_box([](const std::string &) {}, element.text, rect, element.color,
+                                       element.second_color);
+        }
+        ids_by_name.emplace(element.name, element_id);
+    }
+    return ids_by_name;
+}
 
-    auto is = vertex_geometry::generate_rectangle_indices();
-    auto vs =
-        vertex_geometry::generate_rectangle_vertices_with_z(x_pos_ndc, y_pos_ndc, background_layer, width, height);
-    std::vector<glm::vec3> cs(vs.size(), regular_color);
+void compile_ui_layout(const std::string &layout_text, const std::string &path) {
+    UniqueIDGenerator abs_pos_object_id_generator;
+    UI ui(0, abs_pos_object_id_generator);
+    std::unordered_map<int, std::string> names;
+    for (const auto &[name, id] : ui.add_layout_text(layout_text))
+        names.emplace(id, name);
+    ui.save_layout(path, names);
+}
 
-    draw_info::IVPColor ivpsc(is, vs, cs, rect_id);
-    vertex_geometry::Rectangle rect(glm::vec3(x_pos_ndc, y_pos_ndc, text_layer), width, height);
+static const char *get_profile_phase_name(UIProfilePhase phase) {
+    switch (phase) {
+    case UIProfilePhase::update:
+        return "update";
+    case UIProfilePhase::scroll:
+        return "scroll";
+    case UIProfilePhase::hover:
+        return "hover";
+    case UIProfilePhase::input:
+        return "input";
+    case UIProfilePhase::click:
+        return "click";
+    case UIProfilePhase::snapshot:
+        return "snapshot";
+    case UIProfilePhase::buffer_submission:
+        return "buffer_submission";
+    case UIProfilePhase::render_submission:
+        return "render_submission";
+    case UIProfilePhase::count:
+    default:
+        return "unknown";
+    }
+}
 
-    draw_info::IndexedVertexPositions text_ivp = grid_font::get_text_geometry(placeholder_text, rect);
-    std::vector<glm::vec3> text_cs(text_ivp.xyz_positions.size(), glm::vec3(1, 1, 1));
-    draw_info::IVPColor text_ivpsc(text_ivp, text_cs, text_data_id);
+std::string make_chrome_trace(const std::vector<UIFrameProfile> &frame_profiles) {
+    std::string json = "{\"traceEvents\":[";
+    bool first_event = true;
+    auto add_event = [&](const std::string &event) {
+        if (not first_event)
+            json += ',';
+        first_event = false;
+        json += event;
+    };
+
+    for (const auto &profile : frame_profiles) {
+        add_event("{\"name\":\"frame " + std::to_string(profile.frame_number) +
+                  "\",\"cat\":\"ui\",\"ph\":\"X\",\"pid\":0,\"tid\":0,\"ts\":" +
+                  std::to_string(profile.start_us) + ",\"dur\":" + std::to_string(profile.duration_us) + "}");
+        for (size_t i = 0; i < static_cast<size_t>(UIProfilePhase::count); i++) {
+            if (profile.phase_duration_us[i] == 0)
+                continue;
+            add_event("{\"name\":\"" + std::string(get_profile_phase_name(static_cast<UIProfilePhase>(i))) +
+                      "\",\"cat\":\"ui\",\"ph\":\"X\",\"pid\":0,\"tid\":0,\"ts\":" +
+                      std::to_string(profile.phase_start_us[i]) +
+                      ",\"dur\":" + std::to_string(profile.phase_duration_us[i]) + "}");
+        }
+        add_event("{\"name\":\"ui counters\",\"ph\":\"C\",\"pid\":0,\"ts\":" + std::to_string(profile.start_us) +
+                  ",\"args\":{\"text_geometry_generations\":" + std::to_string(profile.text_geometry_generations) +
+                  ",\"bytes_marked_dirty\":" + std::to_string(profile.bytes_marked_dirty) +
+                  ",\"elements_submitted\":" + std::to_string(profile.elements_submitted) +
+                  ",\"heap_allocations\":" + std::to_string(profile.heap_allocations) + "}}");
+    }
+
+    json += "]}";
+    return json;
+}
 
-    input_boxes.emplace_back(on_confirm, ivpsc, text_ivpsc, placeholder_text, "", regular_color, focused_color, rect,
-                             element_id, initial_ignore_character);
+#ifdef UI_PROFILING
+static double get_profile_time_us() {
+    return std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
 
-    return element_id;
+/**
+ * @brief measures the phase from where it's constructed until the end of the scope
+ */
+class UIProfilePhaseTimer {
+  public:
+    UIProfilePhaseTimer(UIFrameProfile &profile, UIProfilePhase phase)
+        : profile(profile), phase(static_cast<size_t>(phase)), start_us(get_profile_time_us()) {}
+    ~UIProfilePhaseTimer() {
+        profile.phase_start_us[phase] = start_us;
+        profile.phase_duration_us[phase] = get_profile_time_us() - start_us;
+    }
+
+  private:
+    UIFrameProfile &profile;
+    size_t phase;
+    double start_us;
 };
 
-std::vector<UIClickableTextBox> &UI::get_clickable_text_boxes() { return clickable_text_boxes; }
-std::vector<UIDropdown> &UI::get_dropdowns() { return dropdowns; }
-std::vector<UIInputBox> &UI::get_input_boxes() { return input_boxes; }
-std::vector<UITextBox> &UI::get_text_boxes() { return text_boxes; }
-std::vector<UIRect> &UI::get_colored_boxes() { return rectangles; }
+#define UI_PROFILE_PHASE(ui, phase) UIProfilePhaseTimer ui_profile_phase_timer((ui).last_frame_profile, phase)
+#else
+// NOTE: compiles away entirely so that there is no overhead when not profiling
+#define UI_PROFILE_PHASE(ui, phase)
+#endif
 
 void process_and_queue_render_ui(glm::vec2 ndc_mouse_pos, UI &curr_ui, IUIRenderSuite &ui_render_suite,
                                  const std::vector<std::string> &key_strings_just_pressed,
                                  bool delete_action_just_pressed, bool confirm_action_just_pressed,
-                                 bool mouse_just_clicked) {
-
-    curr_ui.process_mouse_position(ndc_mouse_pos);
-    for (const auto &key_str : key_strings_just_pressed) {
-        curr_ui.process_key_press(key_str);
+                                 bool mouse_just_clicked, float mouse_scroll_amount) {
+    size_t heap_allocation_count_at_start = get_heap_allocation_count();
+#ifdef UI_PROFILING
+    UIFrameProfile &profile = curr_ui.last_frame_profile;
+    profile = UIFrameProfile();
+    profile.frame_number = curr_ui.get_frame_number();
+    profile.start_us = get_profile_time_us();
+    size_t text_geometry_generations_at_start = curr_ui.get_text_geometry_generation_count();
+#endif
+
+    {
+        UI_PROFILE_PHASE(curr_ui, UIProfilePhase::update);
+        curr_ui.apply_queued_commands();
+        curr_ui.update_file_browsers();
+        curr_ui.update_layout();
     }
 
-    if (delete_action_just_pressed) {
-        curr_ui.process_delete_action();
+    {
+        UI_PROFILE_PHASE(curr_ui, UIProfilePhase::scroll);
+        curr_ui.process_mouse_scroll(ndc_mouse_pos, mouse_scroll_amount);
     }
+    {
+        UI_PROFILE_PHASE(curr_ui, UIProfilePhase::hover);
+        curr_ui.process_mouse_position(ndc_mouse_pos);
+    }
+
+    {
+        UI_PROFILE_PHASE(curr_ui, UIProfilePhase::input);
+        for (const auto &key_str : key_strings_just_pressed) {
+            curr_ui.process_key_press(key_str);
+        }
+
+        if (delete_action_just_pressed) {
+            curr_ui.process_delete_action();
+        }
 
-    if (confirm_action_just_pressed) {
-        curr_ui.process_confirm_action();
+        if (confirm_action_just_pressed) {
+            curr_ui.process_confirm_action();
+        }
     }
 
     if (mouse_just_clicked) {
+        UI_PROFILE_PHASE(curr_ui, UIProfilePhase::click);
         curr_ui.process_mouse_just_clicked(ndc_mouse_pos);
     }
 
-    for (auto &cb : curr_ui.get_colored_boxes()) {
-        ui_render_suite.render_colored_box(cb);
+    if (curr_ui.publish_render_snapshots) {
+        UI_PROFILE_PHASE(curr_ui, UIProfilePhase::snapshot);
+        curr_ui.publish_render_snapshot();
     }
 
-    for (auto &tb : curr_ui.get_text_boxes()) {
-        if (not tb.hidden)
-            ui_render_suite.render_text_box(tb);
+    {
+        UI_PROFILE_PHASE(curr_ui, UIProfilePhase::buffer_submission);
+        ui_render_suite.process_buffer_modifications(curr_ui.get_buffer_modifications());
     }
 
-    for (auto &cr : curr_ui.get_clickable_text_boxes()) {
-        ui_render_suite.render_clickable_text_box(cr);
+    const auto &render_list = curr_ui.get_render_list();
+    {
+        UI_PROFILE_PHASE(curr_ui, UIProfilePhase::render_submission);
+        ui_render_suite.render_ui(curr_ui, render_list, curr_ui.has_changed_since_last_frame());
     }
 
-    for (auto &ib : curr_ui.get_input_boxes()) {
-        ui_render_suite.render_input_box(ib);
-    }
+#ifdef UI_PROFILING
+    profile.text_geometry_generations =
+        curr_ui.get_text_geometry_generation_count() - text_geometry_generations_at_start;
+    profile.bytes_marked_dirty = curr_ui.get_buffer_modification_byte_count();
+    profile.elements_submitted = render_list.size();
+#endif
+
+    curr_ui.finish_frame();
+    curr_ui.heap_allocations_last_frame = get_heap_allocation_count() - heap_allocation_count_at_start;
+
+#ifdef UI_PROFILING
+    profile.heap_allocations = curr_ui.heap_allocations_last_frame;
+    profile.duration_us = get_profile_time_us() - profile.start_us;
+    if (curr_ui.record_frame_profiles)
+        curr_ui.recorded_frame_profiles.push_back(profile);
+#endif
+}
 
-    for (auto &dd : curr_ui.get_dropdowns()) {
-        ui_render_suite.render_dropdown(dd);
-        if (dd.dropdown_open) {
-            int num_dropdowns = dd.ui_dropdown_options.size();
-            for (auto &udo : dd.ui_dropdown_options) {
-                ui_render_suite.render_dropdown_option(udo);
-            }
+// NOTE: the default has nothing of its own to re-use, so it draws everything whether or not something changed
+void IUIRenderSuite::render_ui(UI &ui, const std::vector<UIDrawItem> &render_list,
+                               bool /*changed_since_last_frame*/) {
+    for (const auto &item : render_list) {
+        switch (item.kind) {
+        case UIElementKind::colored_rectangle:
+            render_colored_box(*ui.get_colored_rectangle(item.id));
+            break;
+        case UIElementKind::textbox:
+            render_text_box(*ui.get_textbox(item.id));
+            break;
+        case UIElementKind::clickable_textbox:
+            render_clickable_text_box(*ui.get_clickable_textbox(item.id));
+            break;
+        case UIElementKind::input_box:
+            render_input_box(*ui.get_inputbox(item.id));
+            break;
+        case UIElementKind::dropdown:
+            render_dropdown(*ui.get_dropdown(item.id));
+            break;
+        case UIElementKind::dropdown_option: {
+            render_dropdown_option(ui.get_dropdown(item.id)->ui_dropdown_options[item.option_index]);
+            break;
+        }
+        case UIElementKind::scroll_list_row:
+            render_text_box(ui.get_scroll_list(item.id)->rows[item.option_index]);
+            break;
+        case UIElementKind::log:
+            render_log(*ui.get_log(item.id));
+            break;
         }
     }
 }
@@ -1,9 +1,22 @@
 #ifndef UI_HPP
 #define UI_HPP
 
+#include <array>
+#include <atomic>
+#include <cstdint>
 #include <functional>
 #include <glm/fwd.hpp>
+#include <list>
+#include <memory>
+#include <mutex>
 #include <optional>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <type_traits>
+#include <unordered_map>
+#include <vector>
 #include "sbpt_generated_includes.hpp"
 
 struct FileBrowser {
@@ -30,25 +43,288 @@ struct FileBrowser {
           open_button(vertex_geometry::create_rectangle(0.4 * width, -0.4 * height, 0.1 * width, 0.1 * height)),
           close_button(vertex_geometry::create_rectangle(0.4 * width, 0.4 * height, 0.05 * width, 0.05 * height)),
           up_a_dir_button(vertex_geometry::create_rectangle(-0.4 * width, 0.4 * height, 0.05 * width, 0.05 * height)) {}
+
+    // NOTE: everything below is only used once the file browser has been added to a UI with UI::add_file_browser, it
+    // is then made up of regular ui elements laid out in the rectangles above, these are their ids
+    int id = -1;
+    int background_id = -1;
+    int current_directory_id = -1;
+    int file_view_id = -1;
+    int file_selection_id = -1;
+    int open_button_id = -1;
+    int close_button_id = -1;
+    int up_a_dir_button_id = -1;
+
+    std::function<void(const std::string &)> on_open;
+    std::function<void()> on_close;
+
+    std::string current_directory;
+    std::string selected_file;
+
+    // NOTE: which listing of the current directory the file view shows and how many of its entries it has so far
+    uint64_t shown_listing_generation = 0;
+    size_t shown_entry_count = 0;
+};
+
+/**
+ * @brief caches the geometry grid_font generates for strings, one instance is shared by every UI
+ *
+ * the geometry of a string only depends on the text and the size of the rectangle it is fit into, so we store it
+ * relative to the center of that rectangle and translate it into place whenever it's requested again. This makes
+ * strings that show up over and over again (fps counters, scores, dropdown labels) almost free to re-display.
+ *
+ * @note the least recently used string is evicted once the capacity is reached, use the hit and miss counts to size it.
+ */
+class TextGeometryCache {
+  public:
+    explicit TextGeometryCache(size_t capacity = 4096) : capacity(capacity) {}
+
+    /**
+     * @brief the cache used by every UI
+     */
+    static TextGeometryCache &get_shared();
+
+    /**
+     * @brief the geometry of the text centered on the rectangle
+     * @param generation_count if given it's incremented when the text wasn't cached and had to be generated, which is
+     * how a caller can tell the text it generated apart from the text generated by everyone else using the cache
+     */
+    draw_info::IndexedVertexPositions get_text_geometry(std::string_view text, const vertex_geometry::Rectangle &rect,
+                                                        size_t *generation_count = nullptr);
+
+    /**
+     * @brief writes the geometry of the text into the given drawing data, re-using the storage it already has
+     * @note every vertex is colored white (unless per_vertex_colors is false in which case there are no colors) and
+     * the buffer is marked as modified, the id is left alone.
+     */
+    void write_text_geometry(std::string_view text, const vertex_geometry::Rectangle &rect,
+                             draw_info::IVPColor &ivpsc, bool per_vertex_colors = true,
+                             size_t *generation_count = nullptr);
+
+    /**
+     * @brief same as write_text_geometry but adds the geometry after what's already in the drawing data
+     * @note the buffer is not marked as modified, that is left to the caller
+     */
+    void append_text_geometry(std::string_view text, const vertex_geometry::Rectangle &rect,
+                              draw_info::IVPColor &ivpsc, bool per_vertex_colors = true,
+                              size_t *generation_count = nullptr);
+    void append_text_geometry(std::string_view text, const vertex_geometry::Rectangle &rect,
+                              std::vector<glm::vec3> &xyz_positions, std::vector<unsigned int> &indices,
+                              size_t *generation_count = nullptr);
+
+    // NOTE: these take the lock since other threads may be generating text at the same time, see UI::add_textboxes
+    size_t get_hit_count() const;
+    size_t get_miss_count() const;
+    size_t size() const;
+    void set_capacity(size_t new_capacity);
+    void clear();
+
+  private:
+    struct Key {
+        std::string text;
+        float width;
+        float height;
+    };
+
+    struct KeyView {
+        std::string_view text;
+        float width;
+        float height;
+    };
+
+    // NOTE: transparent so that we can look things up without copying the string into a Key first
+    struct KeyHash {
+        using is_transparent = void;
+        size_t operator()(const KeyView &key) const;
+        size_t operator()(const Key &key) const { return (*this)(KeyView{key.text, key.width, key.height}); }
+    };
+
+    struct KeyEqual {
+        using is_transparent = void;
+        static KeyView view(const Key &key) { return {key.text, key.width, key.height}; }
+        static KeyView view(const KeyView &key) { return key; }
+        template <typename A, typename B> bool operator()(const A &a, const B &b) const {
+            KeyView va = view(a), vb = view(b);
+            return va.text == vb.text and va.width == vb.width and va.height == vb.height;
+        }
+    };
+
+    struct Entry {
+        // positions are relative to the center of the rectangle the text was fit into
+        draw_info::IndexedVertexPositions centered_ivp;
+        std::list<Key>::iterator lru_position;
+    };
+
+    /**
+     * @brief returns the centered geometry for the text, generating it if required
+     * @note the mutex must be held by the caller, it's released while generating so that other threads can keep using
+     * the cache, by the time this returns it's held again.
+     */
+    const draw_info::IndexedVertexPositions &lookup(std::unique_lock<std::mutex> &lock, std::string_view text,
+                                                    const vertex_geometry::Rectangle &rect, size_t *generation_count);
+    void evict_until_within_capacity();
+
+    mutable std::mutex mutex;
+    std::unordered_map<Key, Entry, KeyHash, KeyEqual> entries;
+    // NOTE: the most recently used key is at the front
+    std::list<Key> lru_order;
+    size_t capacity;
+    size_t hit_count = 0;
+    size_t miss_count = 0;
+};
+
+struct UIDirectoryEntry {
+    std::string name;
+    bool is_directory;
+};
+
+/**
+ * @brief lists directories on background threads and remembers the listings
+ *
+ * listing a directory with a huge number of entries can take a long time, so it happens on its own thread and the
+ * entries trickle in whenever poll is called, that way the frame never waits on the file system. Listings are kept
+ * around so that going back to a directory is instant. On linux every listed directory is watched with inotify and gets
+ * listed again when something in it changes, elsewhere use invalidate.
+ *
+ * @note not thread safe, everything but the listing itself happens on the thread that calls these.
+ */
+class UIDirectoryListingCache {
+  public:
+    struct Listing {
+        std::vector<UIDirectoryEntry> entries;
+        // NOTE: false while entries are still coming in
+        bool complete = false;
+        // NOTE: why the directory couldn't be listed, if it couldn't be
+        std::string error;
+        // NOTE: changes whenever entries gets replaced instead of appended to, so anyone showing the entries knows that
+        // they have to start over
+        uint64_t generation = 0;
+
+      private:
+        friend class UIDirectoryListingCache;
+        struct Job;
+        // NOTE: shared with the listing thread, which is detached so that dropping a listing never waits on it
+        std::shared_ptr<Job> job;
+        // NOTE: when a listed directory changes the old entries are kept until the new ones are complete, the new ones
+        // are collected here in the meantime
+        std::vector<UIDirectoryEntry> relisted_entries;
+        bool relisting = false;
+        int watch_descriptor = -1;
+        uint64_t last_requested = 0;
+    };
+
+    // NOTE: defined in ui.cpp along with the destructor, where the listing jobs are complete types
+    explicit UIDirectoryListingCache(size_t capacity = 32);
+    ~UIDirectoryListingCache();
+
+    UIDirectoryListingCache(const UIDirectoryListingCache &) = delete;
+    UIDirectoryListingCache &operator=(const UIDirectoryListingCache &) = delete;
+
+    /**
+     * @brief the listing of the directory as far as it has been listed, starts listing it if it isn't cached
+     * @note the reference is valid until the next call to anything else
+     */
+    const Listing &request(const std::string &directory);
+
+    /**
+     * @brief moves whatever was listed since the last call into the listings, and relists directories that changed
+     */
+    void poll();
+
+    /// @brief lists the directory again, the current entries are kept until the new ones are complete
+    void invalidate(const std::string &directory);
+
+    size_t size() const { return listings.size(); }
+
+  private:
+    void start_listing(const std::string &directory, Listing &listing);
+    void stop_listing(Listing &listing);
+    void evict_until_within_capacity();
+    void process_file_system_changes();
+
+    std::unordered_map<std::string, Listing> listings;
+    size_t capacity;
+    uint64_t request_count = 0;
+    uint64_t next_generation = 1;
+    // NOTE: inotify, only used on linux
+    int watch_file_descriptor = -1;
+    // NOTE: inotify hands out the same watch for every path naming the same directory (a trailing slash, a symlink), so
+    // a watch is shared by all the listings of those paths and only removed along with the last of them
+    std::unordered_map<int, std::vector<std::string>> directories_of_watch;
+    // NOTE: scratch space for process_file_system_changes
+    std::vector<int> changed_watch_descriptors;
+};
+
+/**
+ * @brief computes the smallest axis aligned rectangle in the xy plane containing all the given positions
+ */
+vertex_geometry::Rectangle compute_bounding_rectangle(const std::vector<glm::vec3> &xyz_positions);
+
+/**
+ * @brief where the geometry of a single character lives within a text buffer
+ */
+struct UIGlyphRange {
+    size_t first_vertex;
+    size_t vertex_count;
+    size_t first_index;
+    size_t index_count;
+};
+
+/**
+ * @brief how the text of an element is broken into lines
+ *
+ * with newlines the text is only broken at newlines and every line gets an equal share of the height of the element.
+ * With words lines are also broken between words so that none is wider than the element, every line is then
+ * line_height tall counting down from the top and its characters are half as wide as they are tall, like in input
+ * boxes. Lines that would end up below the element aren't generated.
+ */
+enum class UITextWrap : uint8_t { newlines, words };
+
+/**
+ * @brief a line of the text of an element along with where its geometry lives within the text buffer
+ */
+struct UITextLine {
+    std::string text;
+    UIGlyphRange geometry;
+};
+
+/**
+ * @brief the text of an element and how it was broken into lines
+ *
+ * the lines are kept around so that changing the text only generates the geometry of the lines that changed, lines
+ * after those which didn't change are only moved into place.
+ */
+struct UITextLayout {
+    std::string text;
+    UITextWrap wrap = UITextWrap::newlines;
+    float line_height = 0;
+    std::vector<UITextLine> lines;
 };
 
 struct UIRect {
     int parent_ui_id;
     draw_info::IVPColor ivpsc;
+    // NOTE: only used for hit-testing, the geometry itself lives in ivpsc
+    vertex_geometry::Rectangle bounding_rect;
+    glm::vec3 background_color = glm::vec3(0);
     bool mouse_above = false;
     // TemporalBinarySignal modified_signal;
 
     bool hidden = false;
 
     // TODO: why are we using the global here...
-    UIRect(draw_info::IVPColor ivpsc, int id = GlobalUIDGenerator::get_id()) : parent_ui_id(id), ivpsc(ivpsc) {}
+    UIRect(draw_info::IVPColor ivpsc, int id = GlobalUIDGenerator::get_id())
+        : parent_ui_id(id), ivpsc(ivpsc), bounding_rect(compute_bounding_rectangle(ivpsc.xyz_positions)) {}
 };
 
 struct UITextBox {
     int parent_ui_id;
     draw_info::IVPColor background_ivpsc;
     draw_info::IVPColor text_drawing_ivpsc;
+    UITextLayout text_layout;
     vertex_geometry::Rectangle bounding_rect;
+    glm::vec3 background_color = glm::vec3(0);
+    glm::vec3 text_color = glm::vec3(1, 1, 1);
     bool mouse_above = false;
     // TemporalBinarySignal modified_signal;
 
@@ -66,104 +342,1012 @@ struct UIClickableTextBox {
     std::function<void()> on_hover;
     draw_info::IVPColor ivpsc;
     draw_info::IVPColor text_drawing_ivpsc;
+    UITextLayout text_layout;
     glm::vec3 regular_color;
     glm::vec3 hover_color;
+    glm::vec3 background_color;
+    glm::vec3 text_color = glm::vec3(1, 1, 1);
     vertex_geometry::Rectangle rect;
     bool mouse_inside = false;
+    bool hidden = false;
     // TemporalBinarySignal modified_signal;
 
     UIClickableTextBox(std::function<void()> on_click, std::function<void()> on_hover, draw_info::IVPColor ivpsc,
                        draw_info::IVPColor text_drawing_data, glm::vec3 regular_color, glm::vec3 hover_color,
                        vertex_geometry::Rectangle rect, int id = GlobalUIDGenerator::get_id())
         : on_click(on_click), on_hover(on_hover), ivpsc(ivpsc), text_drawing_ivpsc(text_drawing_data),
-          regular_color(regular_color), hover_color(hover_color), rect(rect), id(id) {}
+          regular_color(regular_color), hover_color(hover_color), background_color(regular_color), rect(rect),
+          id(id) {}
 };
 
 struct UIDropdownOption {
 
     UIDropdownOption(std::string option, glm::vec3 color, glm::vec3 hover_color, draw_info::IVPColor background_ivpsc,
-                     draw_info::IVPColor text_ivpsc, vertex_geometry::Rectangle rect,
-                     std::function<void(const std::string)> on_click, std::function<void(const std::string)> on_hover)
-        : option(std::move(option)), color(color), hover_color(hover_color),
-          background_ivpsc(std::move(background_ivpsc)), text_ivpsc(std::move(text_ivpsc)), rect(rect),
-          on_click(std::move(on_click)), on_hover(std::move(on_hover)) {}
+                     draw_info::IVPColor text_ivpsc, vertex_geometry::Rectangle rect)
+        : option(std::move(option)), color(color), hover_color(hover_color), background_color(color),
+          background_ivpsc(std::move(background_ivpsc)), text_ivpsc(std::move(text_ivpsc)), rect(rect) {}
 
     std::string option;
 
     glm::vec3 color;
     glm::vec3 hover_color;
+    glm::vec3 background_color;
+    glm::vec3 text_color = glm::vec3(1, 1, 1);
 
     draw_info::IVPColor background_ivpsc;
     draw_info::IVPColor text_ivpsc;
 
     // TemporalBinarySignal modified_signal;
 
-    vertex_geometry::Rectangle rect;
+    vertex_geometry::Rectangle rect;
+
+    bool mouse_inside = false;
+};
+
+struct UIDropdown {
+    int id;
+
+    std::string selected_option;
+
+    glm::vec3 regular_color;
+    glm::vec3 hover_color;
+    glm::vec3 background_color;
+    glm::vec3 text_color = glm::vec3(1, 1, 1);
+
+    std::function<void()> on_click;
+    std::function<void()> on_hover;
+    // NOTE: shared by every option, they're called with the option that was clicked or hovered
+    std::function<void(const std::string &)> option_on_click;
+    std::function<void(const std::string &)> option_on_hover;
+
+    draw_info::IVPColor dropdown_background;
+    draw_info::IVPColor dropdown_text_ivpsc;
+    vertex_geometry::Rectangle dropdown_rect;
+
+    // a vector because we have one for each dropdown elt
+
+    std::vector<UIDropdownOption> ui_dropdown_options;
+    bool mouse_inside = false;
+    bool dropdown_open = false;
+    bool hidden = false;
+    // TemporalBinarySignal modified_signal;
+
+    UIDropdown(std::function<void()> on_click, std::function<void()> on_hover, draw_info::IVPColor dropdown_background,
+               draw_info::IVPColor dropdown_text_data, glm::vec3 regular_color, glm::vec3 hover_color,
+               vertex_geometry::Rectangle dropdown_rect, std::vector<UIDropdownOption> ui_dropdown_options,
+               std::function<void(const std::string &)> option_on_click,
+               std::function<void(const std::string &)> option_on_hover, int id = GlobalUIDGenerator::get_id())
+        : on_click(std::move(on_click)), on_hover(std::move(on_hover)), option_on_click(std::move(option_on_click)),
+          option_on_hover(std::move(option_on_hover)), dropdown_background(std::move(dropdown_background)),
+          dropdown_text_ivpsc(std::move(dropdown_text_data)), regular_color(regular_color), hover_color(hover_color),
+          background_color(regular_color), dropdown_rect(dropdown_rect),
+          ui_dropdown_options(std::move(ui_dropdown_options)), id(id) {
+        // NOTE:  we're running under the assumption that every dropdown will have at least one option
+        selected_option = this->ui_dropdown_options.at(0).option;
+    }
+};
+
+/**
+ * @brief a scrollable list of strings which only has drawing data for the rows that fit into it
+ *
+ * items is only the data model, no matter how many items there are the list has a fixed number of rows and scrolling
+ * recycles their drawing data, so memory and the cost of a frame don't depend on how many items there are.
+ */
+struct UIScrollList {
+    int id;
+
+    std::vector<std::string> items;
+
+    // NOTE: called with the index of the item within items along with the item itself
+    std::function<void(size_t, const std::string &)> on_click;
+    std::function<void(size_t, const std::string &)> on_hover;
+
+    glm::vec3 regular_color;
+    glm::vec3 hover_color;
+
+    vertex_geometry::Rectangle rect;
+    float row_height;
+
+    // NOTE: row i shows items[first_visible_item + i], rows past the end of the items are hidden, the position of the
+    // rows never changes, only what they show
+    std::vector<UITextBox> rows;
+    size_t first_visible_item = 0;
+    // NOTE: the part of a scroll which didn't amount to a whole row yet
+    float unapplied_scroll = 0;
+    // NOTE: set when the row under the mouse started showing another item, so that the next hover pass hovers it anew
+    bool hovered_row_changed = false;
+    bool hidden = false;
+
+    UIScrollList(std::function<void(size_t, const std::string &)> on_click,
+                 std::function<void(size_t, const std::string &)> on_hover, std::vector<std::string> items,
+                 glm::vec3 regular_color, glm::vec3 hover_color, vertex_geometry::Rectangle rect, float row_height,
+                 std::vector<UITextBox> rows, int id = GlobalUIDGenerator::get_id())
+        : id(id), items(std::move(items)), on_click(std::move(on_click)), on_hover(std::move(on_hover)),
+          regular_color(regular_color), hover_color(hover_color), rect(rect), row_height(row_height),
+          rows(std::move(rows)) {}
+
+    /// @return the index of the item shown by the row, or -1 if the row is past the end of the items
+    long item_index_of_row(size_t row) const {
+        size_t item = first_visible_item + row;
+        return item < items.size() ? static_cast<long>(item) : -1;
+    }
+};
+
+/**
+ * @brief a line of a UILog along with the drawing data of its text
+ */
+struct UILogLine {
+    std::string text;
+    draw_info::IVPColor text_drawing_ivpsc;
+    // NOTE: counts every line ever appended to the log, the first line is 0
+    uint64_t line_number = 0;
+};
+
+/**
+ * @brief a fixed number of lines of text where appending a line pushes out the oldest one, like a console
+ *
+ * lines is a ring buffer with a slot per row, appending writes the new line into the slot of the oldest one and
+ * leaves every other slot alone. The text of every line is generated in the bottom row, a line is drawn where it
+ * belongs by moving it up by get_line_offset, so appending costs the same no matter how many lines are shown.
+ */
+struct UILog {
+    int id;
+
+    draw_info::IVPColor background_ivpsc;
+    glm::vec3 background_color;
+    glm::vec3 text_color = glm::vec3(1, 1, 1);
+
+    vertex_geometry::Rectangle rect;
+    float line_height;
+
+    // NOTE: the line with line_number n is in slot n % lines.size()
+    std::vector<UILogLine> lines;
+    uint64_t appended_line_count = 0;
+
+    bool mouse_above = false;
+    bool hidden = false;
+
+    UILog(draw_info::IVPColor background_ivpsc, glm::vec3 background_color, vertex_geometry::Rectangle rect,
+          float line_height, std::vector<UILogLine> lines, int id = GlobalUIDGenerator::get_id())
+        : id(id), background_ivpsc(std::move(background_ivpsc)), background_color(background_color), rect(rect),
+          line_height(line_height), lines(std::move(lines)) {}
+
+    size_t get_capacity() const { return lines.size(); }
+    /// @return whether the slot holds a line yet, slots are only empty until the log has been filled once
+    bool is_slot_used(size_t slot) const { return slot < appended_line_count; }
+    /// @return how far the text of the line in the slot has to be moved to be drawn in its row
+    glm::vec3 get_line_offset(size_t slot) const {
+        uint64_t lines_below = appended_line_count - 1 - lines[slot].line_number;
+        return glm::vec3(0, line_height * lines_below, 0);
+    }
+};
+
+/**
+ * @brief how a UIContainer arranges its children within its rectangle
+ */
+enum class UILayout : uint8_t {
+    // NOTE: top to bottom, each child gets a share of the height proportional to its weight
+    vertical_stack,
+    // NOTE: left to right, each child gets a share of the width proportional to its weight
+    horizontal_stack,
+    // NOTE: equally sized cells filled row by row, weights are ignored
+    grid
+};
+
+struct UILayoutParameters {
+    UILayout layout = UILayout::vertical_stack;
+    // NOTE: the space between the edges of the container and its children
+    float padding = 0;
+    // NOTE: the space between neighbouring children
+    float spacing = 0;
+    int grid_columns = 1;
+};
+
+struct UIContainerChild {
+    // NOTE: the id of a ui element or of another container
+    int id;
+    bool is_container;
+    float weight = 1;
+    // NOTE: where the last layout put the child, only valid once placed
+    vertex_geometry::Rectangle rect = vertex_geometry::Rectangle(glm::vec3(0), 0, 0);
+    bool placed = false;
+};
+
+/**
+ * @brief an invisible node which lays out ui elements and other containers within its rectangle, like a div
+ *
+ * where each child was put is cached, a container is only laid out again once it's dirty, which happens when its
+ * children change or it gets a different rectangle, and then only the children whose rectangle actually changed are
+ * moved, which for a child container means only its subtree is laid out again.
+ */
+struct UIContainer {
+    int id;
+    UILayoutParameters parameters;
+    vertex_geometry::Rectangle rect;
+    std::vector<UIContainerChild> children;
+    bool layout_dirty = false;
+    // NOTE: hides everything inside of the container, see UI::set_hidden
+    bool hidden = false;
+
+    UIContainer(const UILayoutParameters &parameters, const vertex_geometry::Rectangle &rect,
+                int id = GlobalUIDGenerator::get_id())
+        : id(id), parameters(parameters), rect(rect) {}
+};
+
+/**
+ * @brief a contiguous range of elements within a buffer, used to say which part of a buffer changed
+ */
+struct UIBufferRange {
+    size_t first = 0;
+    size_t count = 0;
+
+    bool empty() const { return count == 0; }
+    void clear() { first = count = 0; }
+
+    /// @brief grows the range so that it also covers the other range
+    void merge(size_t other_first, size_t other_count);
+};
+
+/**
+ * @brief the parts of a draw_info::IVPColor that can change independently of each other
+ */
+enum class UIBufferAttribute : uint8_t {
+    positions = 1 << 0,
+    colors = 1 << 1,
+    indices = 1 << 2,
+    // NOTE: the single background_color/text_color of an element, only used with UIColorMode::uniform
+    uniform_color = 1 << 3
+};
+
+inline uint8_t operator|(UIBufferAttribute a, UIBufferAttribute b) {
+    return static_cast<uint8_t>(a) | static_cast<uint8_t>(b);
+}
+inline uint8_t operator|(uint8_t a, UIBufferAttribute b) { return a | static_cast<uint8_t>(b); }
+
+/**
+ * @brief describes what part of a single buffer changed since the modifications were last cleared
+ *
+ * vertices applies to the positions and colors, indices to the indices, only the attributes that are flagged changed.
+ *
+ * @note the buffer may have grown or shrunk, in which case the ranges extend up to the end of the new data, a renderer
+ * should compare against the size it has allocated.
+ */
+struct UIBufferModification {
+    int buffer_id;
+    uint8_t attributes = 0;
+    UIBufferRange vertices;
+    UIBufferRange indices;
+
+    bool has(UIBufferAttribute attribute) const { return attributes & static_cast<uint8_t>(attribute); }
+};
+
+/**
+ * @brief collects which buffers of a UI were modified during a frame and which parts of them
+ *
+ * multiple modifications to the same buffer are merged into one, so there is at most one entry per buffer. Every
+ * modification also marks the buffer with draw_info's buffer_modification_tracker so that renderers which always
+ * re-upload whole buffers keep working.
+ */
+class UIModifiedBuffers {
+  public:
+    void mark(draw_info::IVPColor &ivpsc, uint8_t attributes, UIBufferRange vertices, UIBufferRange indices = {});
+    void mark(draw_info::IVPColor &ivpsc, UIBufferAttribute attribute, UIBufferRange vertices);
+
+    /// @brief marks every attribute of the entire buffer as modified
+    void mark_everything(draw_info::IVPColor &ivpsc);
+
+    /// @brief stops tracking a buffer, used when the element that owned it is removed
+    void forget(int buffer_id);
+
+    const std::vector<UIBufferModification> &get() const { return modifications; }
+    bool empty() const { return modifications.empty(); }
+    void clear();
+
+    /// @return how many bytes a renderer uploading only the modified ranges would have to upload
+    size_t get_modified_byte_count() const;
+
+  private:
+    struct BufferSlot {
+        int modification_index = -1;
+        // NOTE: the slot is only in use when this is the current generation, which is how clearing is free
+        uint32_t generation = 0;
+    };
+
+    /// @return where the modification of the buffer lives in modifications, or -1 if it wasn't modified
+    int index_of_buffer(int buffer_id) const;
+    /// @return the slot of the buffer, or the unused slot it would go in
+    size_t find_slot(int buffer_id) const;
+    bool is_slot_used(size_t slot) const { return buffer_slots[slot].generation == generation; }
+    void erase_slot(size_t slot);
+    /// @brief makes sure there is room for one more modification without the table getting more than half full
+    void reserve_slot();
+
+    std::vector<UIBufferModification> modifications;
+    // NOTE: an open addressing table from buffer id to modification, buffer ids come from a generator shared with the
+    // whole app so they can be large, this instead grows with how many buffers get modified in a frame and is re-used
+    // from frame to frame without allocating
+    std::vector<BufferSlot> buffer_slots;
+    uint32_t generation = 1;
+};
+
+struct UIInputBox {
+    int id;
+    std::function<void(const std::string &)> on_confirm;
+    draw_info::IVPColor background_ivpsc;
+    draw_info::IVPColor text_drawing_ivpsc;
+    std::string placeholder_text;
+    // NOTE: the wrap and line_height of both layouts are always the same, they're how the whole box wraps its text
+    UITextLayout placeholder_layout;
+    /// @brief the contents as they were laid out, only used when wrapping words, see glyph_ranges for when not
+    UITextLayout contents_layout;
+    std::string contents;
+    glm::vec3 regular_color;
+    glm::vec3 focused_color;
+    glm::vec3 background_color;
+    glm::vec3 text_color = glm::vec3(1, 1, 1);
+    vertex_geometry::Rectangle rect;
+    bool focused = false;
+    bool hidden = false;
+    // TemporalBinarySignal modified_signal;
+    /// @note sometimes you have a key which initializes the input box, and you want to ignore that stroke so that you
+    /// don't get an initial character in the box.
+    std::optional<std::string> initial_ignore_character;
+    bool already_ignored_initial_character_during_active_focus = false;
+
+    /// @brief where typed characters get inserted and which character deleting removes (the one before it)
+    size_t caret_position = 0;
+    // NOTE: while editing a box that doesn't wrap words, each character of contents gets its own cell and we keep track
+    // of where its geometry lives in text_drawing_ivpsc, that way typing or deleting only touches the geometry of the
+    // characters after the caret. Only the characters that fit into the box have geometry, glyph_ranges[i] is the
+    // character at first_visible_glyph + i and the geometry is kept in the same order. A box that wraps words lays the
+    // contents out into lines instead, only the lines from the changed one on get touched.
+    std::vector<UIGlyphRange> glyph_ranges;
+    size_t first_visible_glyph = 0;
+    bool showing_placeholder = true;
+
+    UIInputBox(std::function<void(const std::string &)> on_confirm, draw_info::IVPColor background_ivpsc,
+               draw_info::IVPColor text_drawing_data, std::string placeholder_text, std::string contents,
+               glm::vec3 regular_color, glm::vec3 focused_color, vertex_geometry::Rectangle rect,
+               int id = GlobalUIDGenerator::get_id(),
+               std::optional<std::string> initial_ignore_character = std::nullopt)
+        : on_confirm(on_confirm), background_ivpsc(background_ivpsc), text_drawing_ivpsc(text_drawing_data),
+          placeholder_text(placeholder_text), contents(contents), regular_color(regular_color),
+          focused_color(focused_color), background_color(regular_color), rect(rect), id(id),
+          initial_ignore_character(initial_ignore_character) {}
+};
+
+/**
+ * @brief identifies which kind of ui element an entry in the UISpatialGrid refers to
+ *
+ * @note the order of this enum is also the order in which hovering is processed
+ */
+enum class UIElementKind : uint8_t {
+    colored_rectangle,
+    textbox,
+    clickable_textbox,
+    input_box,
+    dropdown,
+    dropdown_option,
+    scroll_list_row,
+    log
+};
+
+/**
+ * @brief a reference to an element of a UI which can be hit-tested
+ *
+ * id is the ui id of the element, for dropdown options it refers to the dropdown and option_index to the option within
+ * that dropdown, likewise for the rows of a scroll list. order is the insertion order of the element, whatever was
+ * added first gets priority during hit-testing. hit_slot is where its hit-test data lives in the UIHitTestTable.
+ */
+struct UISpatialEntry {
+    UIElementKind kind;
+    int id;
+    int option_index = -1;
+    unsigned int order = 0;
+    uint32_t hit_slot = UINT32_MAX;
+
+    bool operator==(const UISpatialEntry &other) const {
+        return kind == other.kind and id == other.id and option_index == other.option_index;
+    }
+};
+
+enum class UIEventType : uint8_t { clicked, hovered, confirmed };
+
+/**
+ * @brief something that happened to an element of a UI, the alternative to its callbacks
+ *
+ * id is the ui id of the element, for dropdown options it's the dropdown and option_index is the option, for scroll
+ * lists option_index is the index of the item. text is a copy of the contents of a confirmed input box, the option of
+ * a dropdown option or the item of a scroll list and empty otherwise, so that events can be handled on another thread.
+ *
+ * @note only the ui thread may read anything else back from the ui, an event that needs more than this has to be
+ * handled there
+ */
+struct UIEvent {
+    UIEventType type;
+    UIElementKind kind;
+    int id;
+    int option_index = -1;
+    std::string text;
+};
+
+/**
+ * @brief a fixed size lock free ring buffer of ui events with a single producer and a single consumer
+ *
+ * the UI pushes events while processing input and the application drains them once per tick, possibly on another
+ * thread. When the queue is full new events are dropped and counted rather than blocking the ui.
+ */
+class UIEventQueue {
+  public:
+    /// @note the capacity gets rounded up to a power of two
+    explicit UIEventQueue(size_t capacity = 1024);
+
+    /// @return false if the queue was full and the event was dropped
+    bool push(const UIEvent &event);
+    /// @brief same as push but writes the event straight into its slot, which re-uses the storage of its text
+    bool push(UIEventType type, UIElementKind kind, int id, int option_index = -1, std::string_view text = {});
+    /**
+     * @return false if there was nothing to pop
+     * @note the text is copied into the given event, pop into the same event every time so that it re-uses its storage
+     */
+    bool pop(UIEvent &event);
+
+    bool empty() const { return head.load(std::memory_order_acquire) == tail.load(std::memory_order_acquire); }
+    size_t get_dropped_count() const { return dropped_count.load(std::memory_order_relaxed); }
+
+  private:
+    std::vector<UIEvent> events;
+    size_t mask;
+    // NOTE: head is only written by the consumer and tail only by the producer
+    std::atomic<size_t> head{0};
+    std::atomic<size_t> tail{0};
+    std::atomic<size_t> dropped_count{0};
+};
+
+enum class UICommandType : uint8_t { set_text, set_hidden, set_rectangle, set_background_color };
+
+/**
+ * @brief a change to an element of a UI made from some other thread, applied at the start of the next frame
+ *
+ * only the member matching the type is used.
+ */
+struct UICommand {
+    UICommandType type = UICommandType::set_text;
+    int id = -1;
+    std::string text = {};
+    bool hidden = false;
+    vertex_geometry::Rectangle rectangle = vertex_geometry::Rectangle(glm::vec3(0), 0, 0);
+    glm::vec3 color = glm::vec3(0);
+};
+
+/**
+ * @brief a lock free queue of UICommands that any number of threads can push onto, drained by the ui thread
+ *
+ * pushing is a single compare and swap onto a linked list, draining takes the whole list at once so the ui thread
+ * never waits on the threads producing commands. Drained nodes go back onto a free list which pushing takes them from,
+ * so once the queue has grown to hold what gets queued between two frames pushing no longer allocates.
+ */
+class UICommandQueue {
+  public:
+    UICommandQueue() = default;
+    UICommandQueue(const UICommandQueue &) = delete;
+    UICommandQueue &operator=(const UICommandQueue &) = delete;
+    ~UICommandQueue();
+
+    void push(UICommand command);
+
+    /**
+     * @brief calls the function on every queued command, most recent first, and removes them from the queue
+     */
+    void drain_newest_first(const std::function<void(UICommand &)> &process_command);
+
+  private:
+    struct Node {
+        UICommand command;
+        Node *next = nullptr;
+        // NOTE: both count from 1 so that 0 can mean none, next_free is only meaningful while the node is free
+        uint32_t pool_index = 0;
+        std::atomic<uint32_t> next_free{0};
+    };
+    static constexpr size_t nodes_per_block = 256;
+    static constexpr size_t max_block_count = 4096;
+
+    Node *acquire_node();
+    void release_node(Node *node);
+    Node &node_at(uint32_t pool_index);
+
+    std::atomic<Node *> head{nullptr};
+    // NOTE: blocks are never freed or moved while the queue lives, so a node found through a stale free list head can
+    // still be read safely, the compare and swap is what rejects it
+    std::array<std::atomic<Node *>, max_block_count> blocks{};
+    std::atomic<size_t> block_count{0};
+    // NOTE: the pool index of the first free node in the lower 32 bits and a tag that changes on every update in the
+    // upper 32, without the tag a producer could pop a node that was taken and put back since it read the head (ABA)
+    std::atomic<uint64_t> free_head{0};
+};
+
+/**
+ * @brief how a UI lets the application know that something happened
+ */
+enum class UIEventDispatch : uint8_t {
+    // the on_click, on_hover and on_confirm functions of the element are called right away
+    callbacks,
+    // a UIEvent is pushed onto the ui's event queue instead, no callbacks are called
+    event_queue
+};
+
+/**
+ * @brief a single thing to draw from a UI's render list
+ *
+ * like UISpatialEntry it refers to the element by id (and option_index for dropdown options) since elements move around
+ * in memory when others are removed. z is the layer of the element's background, used to sort the list.
+ */
+struct UIDrawItem {
+    UIElementKind kind;
+    int id;
+    int option_index = -1;
+    float z = 0;
+    unsigned int order = 0;
+};
+
+/**
+ * @brief an item of the render list along with everything needed to draw it, as of when the snapshot was published
+ *
+ * the buffer ids refer to the drawing data stored in the snapshot, text_buffer_id is -1 for colored rectangles which
+ * have no text. A UILog is its background followed by an element per line, those have the slot of the line as their
+ * option_index, no background and a text_offset to draw their text with.
+ */
+struct UISnapshotElement {
+    UIDrawItem item;
+    int background_buffer_id = -1;
+    int text_buffer_id = -1;
+    glm::vec3 background_color = glm::vec3(0);
+    glm::vec3 text_color = glm::vec3(1, 1, 1);
+    glm::vec3 text_offset = glm::vec3(0);
+};
+
+/**
+ * @brief an immutable copy of what a UI looked like at the end of its input processing
+ *
+ * this is what a render thread draws from while the logic thread is already changing the ui for the next frame, see
+ * UI::publish_render_snapshot and UI::acquire_render_snapshot.
+ */
+class UIRenderSnapshot {
+  public:
+    /// @brief everything to draw, back to front
+    const std::vector<UISnapshotElement> &get_elements() const { return elements; }
+    const draw_info::IVPColor &get_buffer(int buffer_id) const { return buffers.at(buffer_id).ivpsc; }
+    /// @brief which frame of the ui this is a snapshot of, 0 means nothing was published yet
+    uint64_t get_frame() const { return frame; }
+
+  private:
+    friend class UI;
+
+    struct Buffer {
+        draw_info::IVPColor ivpsc;
+        /// @brief the frame this snapshot last copied the buffer in, it's only copied again once modified after that
+        uint64_t copied_frame = 0;
+        /// @brief the last frame the ui modified the buffer in, only written by the logic thread
+        uint64_t modified_frame = 0;
+        /// @brief the last frame this snapshot drew the buffer in, the buffers that weren't drawn are dropped
+        uint64_t published_frame = 0;
+    };
+
+    std::vector<UISnapshotElement> elements;
+    // NOTE: keyed by buffer id, only holds what was drawn the last time this snapshot was filled so it doesn't grow
+    // with the ids handed out by the shared id generator
+    std::unordered_map<int, Buffer> buffers;
+    uint64_t frame = 0;
+};
+
+/**
+ * @brief the background of a single ui element as one instance of a quad
+ *
+ * every background in the ui is an axis aligned single colored rectangle, so instead of uploading the drawing data of
+ * each one a renderer can draw all of them with one instanced draw of a unit quad, scaled by size and placed at
+ * center.
+ *
+ * @note this is tightly packed (8 floats) so an array of them can be uploaded to an instance buffer as is.
+ */
+struct UIQuadInstance {
+    glm::vec2 center;
+    float z;
+    glm::vec2 size;
+    glm::vec3 color;
+};
+
+// NOTE: instances are uploaded to the gpu as they are, so the layout must stay eight packed floats
+static_assert(sizeof(UIQuadInstance) == 32, "UIQuadInstance must be 32 tightly packed bytes");
+static_assert(std::is_trivially_copyable_v<UIQuadInstance>, "UIQuadInstance must be copyable as raw bytes");
+
+/**
+ * @brief a reference to a ui element that can tell when the element it refers to has been removed
+ *
+ * ids are recycled once an element is removed, so an id alone could end up referring to a completely different element,
+ * the generation is bumped every time an id is removed which lets us detect that.
+ */
+template <typename T> struct UIHandle {
+    int id = -1;
+    unsigned int generation = 0;
+
+    bool operator==(const UIHandle &other) const { return id == other.id and generation == other.generation; }
+};
+
+/**
+ * @brief densely packed storage for ui elements which can be looked up by their ui id in constant time
+ *
+ * the elements live contiguously so iterating over them is cache friendly, and a sparse vector indexed by id tells us
+ * where each one lives. Erasing moves the last element into the hole, so the position (and address) of an element can
+ * change, but its id never does, so always hold on to ids or handles rather than pointers.
+ *
+ * @note ids come from a UniqueIDGenerator so they're small and dense, which is what makes a plain vector a good sparse
+ * index.
+ */
+template <typename T> class UIElementStore {
+  public:
+    using iterator = typename std::vector<T>::iterator;
+
+    /**
+     * @brief constructs the element in place at the back of the store
+     * @return the newly added element
+     */
+    template <typename... Args> T &emplace(int id, Args &&...args) {
+        if (id >= static_cast<int>(sparse.size())) {
+            sparse.resize(id + 1, -1);
+            generations.resize(id + 1, 0);
+        }
+        sparse[id] = static_cast<int>(elements.size());
+        elements.emplace_back(std::forward<Args>(args)...);
+        dense_ids.push_back(id);
+        insertion_orders.push_back(next_insertion_order++);
+        return elements.back();
+    }
+
+    /**
+     * @brief removes the element with the given id by moving the last element into its place
+     * @return whether or not an element with that id existed
+     */
+    bool erase(int id) {
+        int index = index_of(id);
+        if (index == -1) {
+            return false;
+        }
+
+        int last_index = static_cast<int>(elements.size()) - 1;
+        if (index != last_index) {
+            elements[index] = std::move(elements[last_index]);
+            dense_ids[index] = dense_ids[last_index];
+            insertion_orders[index] = insertion_orders[last_index];
+            sparse[dense_ids[index]] = index;
+        }
+
+        elements.pop_back();
+        dense_ids.pop_back();
+        insertion_orders.pop_back();
+        sparse[id] = -1;
+        generations[id]++;
+        return true;
+    }
+
+    /// @return a handle to the element with the given id, the handle is invalid if there is no such element
+    UIHandle<T> handle_of(int id) const {
+        if (not contains(id)) {
+            return {};
+        }
+        return {id, generations[id]};
+    }
+
+    /// @return the element the handle refers to or nullptr if it has since been removed
+    T *get(const UIHandle<T> &handle) {
+        if (not is_valid(handle)) {
+            return nullptr;
+        }
+        return &elements[sparse[handle.id]];
+    }
+
+    bool is_valid(const UIHandle<T> &handle) const {
+        return contains(handle.id) and generations[handle.id] == handle.generation;
+    }
+
+    /// @return the element with the given id or nullptr if there is none
+    T *get(int id) {
+        int index = index_of(id);
+        return index == -1 ? nullptr : &elements[index];
+    }
+
+    /// @return the element with the given id, throws std::out_of_range if there is none
+    T &at(int id) {
+        int index = index_of(id);
+        if (index == -1) {
+            throw std::out_of_range("no ui element with id " + std::to_string(id));
+        }
+        return elements[index];
+    }
+
+    bool contains(int id) const { return index_of(id) != -1; }
+
+    /// @return the position of the element with the given id in the dense array, or -1 if there is none
+    int index_of(int id) const {
+        if (id < 0 or id >= static_cast<int>(sparse.size())) {
+            return -1;
+        }
+        return sparse[id];
+    }
+
+    /// @return the relative order in which the element with the given id was added, smaller means earlier, throws
+    /// std::out_of_range if there is no such element
+    unsigned int insertion_order_of(int id) const {
+        int index = index_of(id);
+        if (index == -1) {
+            throw std::out_of_range("no ui element with id " + std::to_string(id));
+        }
+        return insertion_orders[index];
+    }
+
+    /// @return the id of the element at the given position in the dense array
+    int id_at(size_t index) const { return dense_ids[index]; }
+
+    std::vector<T> &get_elements() { return elements; }
+    const std::vector<T> &get_elements() const { return elements; }
+
+    iterator begin() { return elements.begin(); }
+    iterator end() { return elements.end(); }
+    size_t size() const { return elements.size(); }
+    bool empty() const { return elements.empty(); }
+
+  private:
+    std::vector<T> elements;
+    std::vector<int> dense_ids;
+    std::vector<unsigned int> insertion_orders;
+    std::vector<int> sparse;
+    std::vector<unsigned int> generations;
+    unsigned int next_insertion_order = 0;
+};
+
+/**
+ * @brief the data needed to hit-test every registered entry, kept apart from the elements themselves
+ *
+ * the elements carry their geometry, strings and callbacks which makes them large, so testing them against the mouse
+ * directly drags all of that through the cache. Instead every entry gets a slot here and the bounds and flags of the
+ * slots live in their own dense arrays, testing a slot only touches 17 bytes. Slots of removed entries get reused.
+ */
+class UIHitTestTable {
+  public:
+    static constexpr uint32_t no_slot = UINT32_MAX;
+    static constexpr uint8_t hovered_flag = 0b01;
+    // NOTE: set for options of closed dropdowns and scroll list rows past the end of the items, they can't be hit
+    static constexpr uint8_t inactive_flag = 0b10;
+
+    /// @return the slot the entry was given
+    uint32_t add(const UISpatialEntry &entry, const vertex_geometry::Rectangle &rect, uint8_t initial_flags = 0);
+    void remove(uint32_t slot);
+    /// @return the slot of the entry, or no_slot if it isn't registered
+    uint32_t find(const UISpatialEntry &entry) const;
+
+    bool contains(uint32_t slot, const glm::vec2 &point) const {
+        return point.x >= min_x[slot] and point.x <= max_x[slot] and point.y >= min_y[slot] and point.y <= max_y[slot];
+    }
+    bool has_flag(uint32_t slot, uint8_t flag) const { return flags[slot] & flag; }
+    void set_flag(uint32_t slot, uint8_t flag, bool set) {
+        flags[slot] = set ? flags[slot] | flag : flags[slot] & ~flag;
+    }
+    const UISpatialEntry &get_entry(uint32_t slot) const { return entries[slot]; }
+
+  private:
+    static uint64_t key_of(const UISpatialEntry &entry);
+
+    std::vector<float> min_x, min_y, max_x, max_y;
+    std::vector<uint8_t> flags;
+    // NOTE: only looked at for slots that were actually hit
+    std::vector<UISpatialEntry> entries;
+    std::vector<uint32_t> free_slots;
+    std::unordered_map<uint64_t, uint32_t> slot_of_key;
+};
+
+/**
+ * @brief a uniform grid over ndc space used to accelerate hit-testing
+ *
+ * every slot of the UIHitTestTable is stored in each cell its rectangle overlaps, so finding what is under a point only
+ * requires looking at the slots of a single cell instead of every element of the ui. Anything extending past [-1, 1] is
+ * clamped into the border cells so that it can still be found.
+ */
+class UISpatialGrid {
+  public:
+    explicit UISpatialGrid(int cells_per_axis = 32);
+
+    void insert(uint32_t slot, const vertex_geometry::Rectangle &rect);
+    void remove(uint32_t slot, const vertex_geometry::Rectangle &rect);
+    void clear();
+
+    /**
+     * @brief returns every slot whose rectangle overlaps the cell that contains the point
+     * @note the slots are in no particular order and still need to be tested exactly against the point
+     */
+    const std::vector<uint32_t> &query(const glm::vec2 &point) const;
+
+  private:
+    int cell_coordinate(float ndc) const;
 
-    bool mouse_inside = false;
-    std::function<void(const std::string)> on_click;
-    std::function<void(const std::string)> on_hover;
+    int cells_per_axis;
+    std::vector<std::vector<uint32_t>> cells;
 };
 
-struct UIDropdown {
-    int id;
+/**
+ * @brief how the colors of ui elements are handed to the renderer
+ *
+ * every background and every piece of text in the ui is a single color, with per_vertex that color is duplicated into
+ * the rgb_colors of every vertex of its drawing data. With uniform the rgb_colors are left empty and the renderer is
+ * expected to use the background_color and text_color of the element instead (as a uniform or per instance
+ * attribute), so hovering or focusing an element is a single store instead of rewriting a vector.
+ */
+enum class UIColorMode : uint8_t { per_vertex, uniform };
 
-    std::string selected_option;
+/**
+ * @brief everything needed to add a textbox, used to add many at once with UI::add_textboxes
+ */
+struct UITextboxDescription {
+    std::string text;
+    vertex_geometry::Rectangle rect;
+    glm::vec3 color;
+};
 
+/**
+ * @brief everything needed to add a clickable textbox, used to add many at once with UI::add_clickable_textboxes
+ */
+struct UIClickableTextboxDescription {
+    std::function<void()> on_click;
+    std::function<void()> on_hover;
+    std::string text;
+    vertex_geometry::Rectangle rect;
     glm::vec3 regular_color;
     glm::vec3 hover_color;
+};
 
-    std::function<void()> on_click;
-    std::function<void()> on_hover;
+/**
+ * @brief how many heap allocations the calling thread has made so far
+ *
+ * @note without UI_COUNT_HEAP_ALLOCATIONS defined this is always 0. With it defined ui.cpp leaves this to the program,
+ * which has to replace the global operator new to count, tests/heap_allocation_counter.hpp does both for test and
+ * benchmark programs. It's meant for debugging and tests, not for release builds.
+ */
+size_t get_heap_allocation_count();
 
-    draw_info::IVPColor dropdown_background;
-    draw_info::IVPColor dropdown_text_ivpsc;
-    vertex_geometry::Rectangle dropdown_rect;
+/**
+ * @brief how much the ui logs, every level also includes the ones after it
+ */
+enum class UILogLevel : uint8_t { debug, info, warn, off };
+
+// NOTE: the lowest level that is compiled in at all (0 debug, 1 info, 2 warn, 3 off), logging below it does no work
+// whatever the runtime level is. By default release builds only keep warnings, define it yourself to override that.
+#ifndef UI_COMPILED_LOG_LEVEL
+#ifdef NDEBUG
+#define UI_COMPILED_LOG_LEVEL 2
+#else
+#define UI_COMPILED_LOG_LEVEL 0
+#endif
+#endif
 
-    // a vector because we have one for each dropdown elt
+/**
+ * @brief sets the lowest level the ui logs at, shared by every UI, info by default
+ * @note levels below UI_COMPILED_LOG_LEVEL stay off regardless
+ */
+void set_ui_log_level(UILogLevel level);
+UILogLevel get_ui_log_level();
 
-    std::vector<UIDropdownOption> ui_dropdown_options;
-    bool mouse_inside = false;
-    bool dropdown_open = false;
-    // TemporalBinarySignal modified_signal;
+/**
+ * @brief the phases of process_and_queue_render_ui, in the order they run
+ *
+ * update is applying queued commands, updating file browsers and layout, input is key presses along with the delete and
+ * confirm actions, buffer_submission and render_submission are the calls into the IUIRenderSuite.
+ */
+enum class UIProfilePhase : uint8_t {
+    update,
+    scroll,
+    hover,
+    input,
+    click,
+    snapshot,
+    buffer_submission,
+    render_submission,
+    count
+};
 
-    UIDropdown(std::function<void()> on_click, std::function<void()> on_hover, draw_info::IVPColor dropdown_background,
-               draw_info::IVPColor dropdown_text_data, glm::vec3 regular_color, glm::vec3 hover_color,
-               vertex_geometry::Rectangle dropdown_rect, std::vector<UIDropdownOption> ui_dropdown_options,
-               int id = GlobalUIDGenerator::get_id())
-        : on_click(on_click), on_hover(on_hover), dropdown_background(dropdown_background),
-          dropdown_text_ivpsc(dropdown_text_data), regular_color(regular_color), hover_color(hover_color),
-          dropdown_rect(dropdown_rect), ui_dropdown_options(ui_dropdown_options), id(id) {
-        // NOTE:  we're running under the assumption that every dropdown will have at least one option
-        selected_option = ui_dropdown_options.at(0).option;
+/**
+ * @brief where the time of a single process_and_queue_render_ui went and how much work it did
+ *
+ * times are in microseconds of the steady clock, which is also what chrome trace events use, phases that didn't run
+ * this frame have a duration of 0.
+ *
+ * @note this is only filled when ui.cpp is compiled with UI_PROFILING defined, otherwise nothing is measured at all.
+ */
+struct UIFrameProfile {
+    uint64_t frame_number = 0;
+    double start_us = 0;
+    double duration_us = 0;
+    std::array<double, static_cast<size_t>(UIProfilePhase::count)> phase_start_us{};
+    std::array<double, static_cast<size_t>(UIProfilePhase::count)> phase_duration_us{};
+
+    /// @brief see UI::get_text_geometry_generation_count
+    size_t text_geometry_generations = 0;
+    /// @brief see UI::get_buffer_modification_byte_count
+    size_t bytes_marked_dirty = 0;
+    /// @brief how many items of the render list were handed to the IUIRenderSuite
+    size_t elements_submitted = 0;
+    /// @brief see get_heap_allocation_count
+    size_t heap_allocations = 0;
+
+    double get_phase_duration_us(UIProfilePhase phase) const {
+        return phase_duration_us[static_cast<size_t>(phase)];
     }
 };
 
-struct UIInputBox {
-    int id;
-    std::function<void(std::string)> on_confirm;
-    draw_info::IVPColor background_ivpsc;
-    draw_info::IVPColor text_drawing_ivpsc;
-    std::string placeholder_text;
-    std::string contents;
-    glm::vec3 regular_color;
-    glm::vec3 focused_color;
+/**
+ * @brief turns frame profiles into chrome trace event json, which can be loaded into chrome://tracing or perfetto
+ *
+ * every phase becomes a complete event and the counters of each frame become counter events.
+ */
+std::string make_chrome_trace(const std::vector<UIFrameProfile> &frame_profiles);
+
+/**
+ * @brief a view of text geometry stored in a UILayoutFile, it points straight into the file
+ */
+struct UILayoutGeometryView {
+    const glm::vec3 *xyz_positions = nullptr;
+    size_t vertex_count = 0;
+    const unsigned int *indices = nullptr;
+    size_t index_count = 0;
+};
+
+/**
+ * @brief an element as it's stored in a UILayoutFile
+ *
+ * colors holds the regular color followed by the hover or focused color, text is the text of textboxes and clickable
+ * textboxes and the placeholder text of input boxes. Its geometry is already stored, the text itself and how it's
+ * wrapped are only there so that the loaded element can be changed later on.
+ */
+struct UILayoutElement {
+    UIElementKind kind;
+    std::string_view name;
+    std::string_view text;
+    UITextWrap wrap;
+    float line_height;
     vertex_geometry::Rectangle rect;
-    bool focused = false;
-    // TemporalBinarySignal modified_signal;
-    /// @note sometimes you have a key which initializes the input box, and you want to ignore that stroke so that you
-    /// don't get an initial character in the box.
-    std::optional<std::string> initial_ignore_character;
-    bool already_ignored_initial_character_during_active_focus = false;
+    std::array<glm::vec3, 2> colors;
+    UILayoutGeometryView text_geometry;
+};
 
-    UIInputBox(std::function<void(std::string)> on_confirm, draw_info::IVPColor background_ivpsc,
-               draw_info::IVPColor text_drawing_data, std::string placeholder_text, std::string contents,
-               glm::vec3 regular_color, glm::vec3 focused_color, vertex_geometry::Rectangle rect,
-               int id = GlobalUIDGenerator::get_id(),
-               std::optional<std::string> initial_ignore_character = std::nullopt)
-        : on_confirm(on_confirm), background_ivpsc(background_ivpsc), text_drawing_ivpsc(text_drawing_data),
-          placeholder_text(placeholder_text), contents(contents), regular_color(regular_color),
-          focused_color(focused_color), rect(rect), id(id), initial_ignore_character(initial_ignore_character) {}
+/**
+ * @brief a ui saved with UI::save_layout, opened so that UI::load_layout can add its elements to a ui
+ *
+ * the file stores the elements along with the text geometry they had when saved, so loading never has to generate any
+ * text. It's memory mapped where possible and every element is a view into the mapped file, nothing is parsed or
+ * copied until the elements are added to a ui. Colored rectangles, textboxes, clickable textboxes and input boxes are
+ * stored, callbacks can't be, see UI::load_layout.
+ *
+ * @note the file is written in the byte order of the machine that saved it and is only meant to be loaded on the same
+ * kind of machine
+ * @throws std::runtime_error if the file can't be read or isn't a valid layout file, which includes any offset or index
+ * pointing outside of it
+ */
+class UILayoutFile {
+  public:
+    explicit UILayoutFile(const std::string &path);
+    ~UILayoutFile();
+    UILayoutFile(const UILayoutFile &) = delete;
+    UILayoutFile &operator=(const UILayoutFile &) = delete;
+
+    size_t size() const { return element_count; }
+    UILayoutElement get_element(size_t index) const;
+    /// @brief the z layer of the ui that was saved, loading into a ui on another layer moves the geometry to it
+    float get_z_layer() const;
+
+  private:
+    const char *data = nullptr;
+    size_t byte_count = 0;
+    size_t element_count = 0;
+    bool mapped = false;
+    // NOTE: holds the contents of the file where memory mapping isn't available
+    std::vector<char> read_bytes;
 };
 
 // we work in ndc space, and so z layer refers to what z layer we're on, by default we have 20 z layers of the form
@@ -176,13 +1360,36 @@ struct UIInputBox {
 // automatically now
 class UI {
   public:
-    UI(float z_layer, UniqueIDGenerator &abs_pos_object_id_generator)
+    UI(float z_layer, UniqueIDGenerator &abs_pos_object_id_generator, UIColorMode color_mode = UIColorMode::per_vertex)
         : z_layer(z_layer), background_layer(z_layer - 0.01), text_layer(z_layer - 0.02),
           dropdown_background_layer(z_layer - 0.03), dropdown_text_layer(z_layer - 0.04),
-          abs_pos_object_id_generator(abs_pos_object_id_generator) {};
+          color_mode(color_mode), abs_pos_object_id_generator(abs_pos_object_id_generator) {};
+
+    // NOTE: other threads queue commands into a ui and read its render snapshots through a reference to it, and file
+    // browsers hand their widgets callbacks pointing back at it, so a ui stays where it was made, hold it by pointer
+    // (for example a std::unique_ptr) where it used to be moved or returned by value
+    UI(const UI &) = delete;
+    UI &operator=(const UI &) = delete;
+    UI(UI &&) = delete;
+    UI &operator=(UI &&) = delete;
 
     float z_layer, background_layer, text_layer, dropdown_background_layer, dropdown_text_layer;
 
+    const UIColorMode color_mode;
+
+    /// @brief how many heap allocations the last process_and_queue_render_ui made, see get_heap_allocation_count
+    size_t heap_allocations_last_frame = 0;
+
+    /// @brief the profile of the last process_and_queue_render_ui, only filled when compiled with UI_PROFILING
+    UIFrameProfile last_frame_profile;
+    /// @brief when true every frame profile is also appended to recorded_frame_profiles, to later make a chrome trace
+    bool record_frame_profiles = false;
+    std::vector<UIFrameProfile> recorded_frame_profiles;
+
+    UIEventDispatch event_dispatch = UIEventDispatch::callbacks;
+    /// @brief only filled when event_dispatch is UIEventDispatch::event_queue, drain it every tick
+    UIEventQueue &get_event_queue() { return event_queue; }
+
     UniqueIDGenerator ui_id_generator;
 
     // TODO: I don't like that these are here, but I don't really have a choice right now correct?
@@ -195,6 +1402,14 @@ class UI {
     bool process_mouse_just_clicked_on_input_boxes(const glm::vec2 &mouse_pos_ndc);
     bool process_mouse_just_clicked_on_dropdown_options(const glm::vec2 &mouse_pos_ndc);
     bool process_mouse_just_clicked_on_dropdowns(const glm::vec2 &mouse_pos_ndc);
+    bool process_mouse_just_clicked_on_scroll_lists(const glm::vec2 &mouse_pos_ndc);
+
+    /**
+     * @brief scrolls the scroll list under the mouse
+     * @param scroll_amount in rows, positive scrolls towards the start of the list like the y offset of a mouse wheel,
+     * fractions add up until they amount to a whole row
+     */
+    void process_mouse_scroll(const glm::vec2 &mouse_pos_ndc, float scroll_amount);
 
     void unfocus_input_box(UIInputBox &ib);
     void unfocus_input_box(int input_box_eid);
@@ -208,15 +1423,23 @@ class UI {
     void process_confirm_action();
     void process_delete_action();
 
+    /**
+     * @brief moves the caret of an input box, characters are then typed and deleted at that position
+     * @note the position is clamped to the contents of the box
+     */
+    void set_input_box_caret_position(int input_box_id, size_t position);
+    void move_input_box_caret(int input_box_id, int offset);
+
     /**
      * @brief adds a colored retangle the ui.
      *
+     * @return the id of the rectangle
      */
-    void add_colored_rectangle(vertex_geometry::Rectangle ndc_rectangle, const glm::vec3 &normalized_rgb);
+    int add_colored_rectangle(vertex_geometry::Rectangle ndc_rectangle, const glm::vec3 &normalized_rgb);
 
     // WARN: deprecated
-    void add_colored_rectangle(float x_pos_ndc, float y_pos_ndc, float width, float height,
-                               const glm::vec3 &normalized_rgb);
+    int add_colored_rectangle(float x_pos_ndc, float y_pos_ndc, float width, float height,
+                              const glm::vec3 &normalized_rgb);
 
     /*void add_clickable_colored_rectangle(std::function<void()> on_click, float x_pos_ndc, float y_pos_ndc, float
      * width,*/
@@ -230,13 +1453,54 @@ class UI {
 
     void hide_textbox(int doid);
     void unhide_textbox(int doid);
+
+    /**
+     * @brief hides or shows an element, for a container or file browser it's everything inside of it
+     *
+     * hidden elements, along with elements which are entirely outside of [-1, 1], are taken out of hit-testing and the
+     * render list, so they take no part in processing input or rendering and cost nothing per frame. An element inside
+     * of a hidden container stays hidden even if it isn't hidden itself.
+     */
+    void set_hidden(int element_id, bool hidden);
+    /// @return whether the element is neither hidden (by itself or a container) nor off screen
+    bool is_shown(int element_id) const {
+        return element_id >= 0 and element_id < static_cast<int>(element_shown.size()) and element_shown[element_id];
+    }
+    /**
+     * @brief changes the text of a textbox or clickable textbox
+     * @note only the lines that changed get their geometry generated, so appending to a large text is cheap
+     */
     void modify_text_of_a_textbox(int doid, std::string new_text);
+    /**
+     * @brief changes how the text of a textbox, clickable textbox or input box is broken into lines, see UITextWrap
+     * @param line_height only used when wrapping words
+     * @note an input box wraps both its placeholder and what's typed into it, without wrapping words what's typed is
+     * always a single line
+     */
+    void set_text_wrap(int element_id, UITextWrap wrap, float line_height = 0);
     void modify_colored_rectangle(int doid, vertex_geometry::Rectangle ndc_rectangle);
+    /// @brief changes the color of a colored rectangle or the background of a textbox
+    void modify_background_color(int doid, const glm::vec3 &color);
+
+    /*
+     * these can be called from any thread, the changes are queued and applied at the start of the next frame by
+     * apply_queued_commands. If the same thing about the same element is changed multiple times in between only the
+     * last change is applied.
+     */
+    void queue_modify_text_of_a_textbox(int doid, std::string new_text);
+    void queue_set_textbox_hidden(int doid, bool hidden);
+    void queue_modify_colored_rectangle(int doid, vertex_geometry::Rectangle ndc_rectangle);
+    void queue_modify_background_color(int doid, const glm::vec3 &color);
+
+    /// @brief applies everything queued by the queue_* functions, must be called on the thread that owns the ui
+    void apply_queued_commands();
 
     // TODO: just return references, I did pointers because I didn't know I could return references I think
     UITextBox *get_textbox(int doid);
     UIInputBox *get_inputbox(int doid);
     UIRect *get_colored_rectangle(int doid);
+    UIDropdown *get_dropdown(int doid);
+    UIScrollList *get_scroll_list(int doid);
 
     /* why we pass our fucntions by reference:
      * Capturing State in Lambdas:
@@ -260,9 +1524,22 @@ class UI {
 
     // in the future these probably don't have to be nodiscard so long as a I have a method for geting ids back out.
     int add_clickable_textbox(std::function<void()> on_click, std::function<void()> on_hover, const std::string &text,
-                              vertex_geometry::Rectangle &rect, const glm::vec3 &regular_color,
+                              const vertex_geometry::Rectangle &rect, const glm::vec3 &regular_color,
                               const glm::vec3 &hover_color);
 
+    /**
+     * @brief adds many textboxes at once, the text geometry of all of them is generated in parallel
+     *
+     * ids are handed out in the order of the descriptions, so the result is exactly the same as calling add_textbox
+     * for each description in order, just faster when there are a lot of them.
+     *
+     * @return the id of each textbox, in the order of the descriptions
+     */
+    std::vector<int> add_textboxes(const std::vector<UITextboxDescription> &descriptions);
+
+    /// @brief same as add_textboxes but for clickable textboxes
+    std::vector<int> add_clickable_textboxes(const std::vector<UIClickableTextboxDescription> &descriptions);
+
     /**
      * @brief Adds a dropdown UI element with a main button and multiple selectable options.
      *
@@ -302,24 +1579,201 @@ class UI {
     int add_dropdown(std::function<void()> on_click, std::function<void()> on_hover, int dropdown_option_idx,
                      const vertex_geometry::Rectangle &rect, const glm::vec3 &regular_color,
                      const glm::vec3 &hover_color, const std::vector<std::string> &options,
-                     std::function<void(std::string)> option_on_click, std::function<void(std::string)> option_on_hover,
+                     std::function<void(const std::string &)> option_on_click,
+                     std::function<void(const std::string &)> option_on_hover,
                      const glm::vec3 &option_color = glm::vec3(0), const glm::vec3 &option_hover_color = glm::vec3(0));
 
-    // TODO: for now I'm not going to trust these remove methods I think.
+    /*
+     * removing an element is constant time, the last element of the same kind is moved into its place, so pointers
+     * returned by the get_* methods are invalidated by any removal, ids and handles are not. Removed ids are handed
+     * back to the ui_id_generator and can be reused, use a handle if you need to know whether the element you're
+     * referring to is still around.
+     */
+    bool remove_colored_rectangle(int do_id);
     bool remove_clickable_textbox(int do_id);
     bool remove_textbox(int do_id);
+    bool remove_input_box(int do_id);
+    bool remove_dropdown(int do_id);
+    bool remove_scroll_list(int do_id);
     UIClickableTextBox *get_clickable_textbox(int do_id);
 
-    int add_input_box(std::function<void(std::string)> on_confirm, const std::string &placeholder_text,
+    /**
+     * @brief gets a handle to the element of type T with the given id, eg get_handle<UITextBox>(id)
+     * @note T is one of UIRect, UITextBox, UIClickableTextBox, UIInputBox, UIDropdown, UIScrollList, FileBrowser or
+     * UIContainer
+     */
+    template <typename T> UIHandle<T> get_handle(int do_id) { return get_store<T>().handle_of(do_id); }
+
+    /// @return the element the handle refers to or nullptr if it has been removed since the handle was made
+    template <typename T> T *get(const UIHandle<T> &handle) { return get_store<T>().get(handle); }
+
+    template <typename T> bool is_valid(const UIHandle<T> &handle) { return get_store<T>().is_valid(handle); }
+
+    int add_input_box(std::function<void(const std::string &)> on_confirm, const std::string &placeholder_text,
                       const vertex_geometry::Rectangle &ndc_rect, const glm::vec3 &regular_color,
                       const glm::vec3 &focused_color,
                       std::optional<std::string> initial_ignore_character = std::nullopt);
 
-    int add_input_box(std::function<void(std::string)> on_confirm, const std::string &placeholder_text, float x_pos_ndc,
-                      float y_pos_ndc, float width, float height, const glm::vec3 &regular_color,
+    int add_input_box(std::function<void(const std::string &)> on_confirm, const std::string &placeholder_text,
+                      float x_pos_ndc, float y_pos_ndc, float width, float height, const glm::vec3 &regular_color,
                       const glm::vec3 &focused_color,
                       std::optional<std::string> initial_ignore_character = std::nullopt);
 
+    /**
+     * @brief adds a list of items which can be scrolled through, only as many rows as fit into the rectangle get
+     * drawing data, so this is fine for hundreds of thousands of items
+     *
+     * @param rect the area the list occupies, rows are laid out from the top of it
+     * @param row_height the height of each row, as many rows as fit into rect are created
+     * @throws std::invalid_argument if the row height isn't positive
+     * @param on_click called with the index of the item and the item when a row is clicked
+     * @param on_hover called with the index of the item and the item when a row starts being hovered
+     *
+     * @return the id of the scroll list
+     */
+    int add_scroll_list(std::function<void(size_t, const std::string &)> on_click,
+                        std::function<void(size_t, const std::string &)> on_hover,
+                        const vertex_geometry::Rectangle &rect, float row_height, const glm::vec3 &regular_color,
+                        const glm::vec3 &hover_color, std::vector<std::string> items);
+
+    /// @brief replaces the items of a scroll list, the scroll position is kept as far as the new items allow
+    void set_scroll_list_items(int scroll_list_id, std::vector<std::string> items);
+    /// @brief adds items to the end of a scroll list, only rows which had nothing to show are updated
+    void append_scroll_list_items(int scroll_list_id, std::vector<std::string> items);
+    /// @brief scrolls so that the given item is the first one visible, clamped so the list never scrolls past its end
+    void scroll_list_to(int scroll_list_id, size_t first_visible_item);
+    /// @brief scrolls by a number of rows, positive moves towards the end of the list
+    void scroll_list_by(int scroll_list_id, long row_offset);
+
+    /**
+     * @brief adds a log which shows the last capacity lines appended to it, newest at the bottom
+     *
+     * @param rect the area the log occupies, it's split into capacity rows
+     * @param capacity how many lines are kept and shown
+     *
+     * @return the id of the log
+     */
+    int add_log(const vertex_geometry::Rectangle &rect, size_t capacity, const glm::vec3 &background_color);
+    /**
+     * @brief adds a line to the bottom of a log, pushing out the oldest line once the log is full
+     * @note only the geometry of the new line is generated, no matter how many lines the log shows
+     */
+    void append_log_line(int log_id, std::string line);
+    /// @brief removes every line from a log
+    void clear_log(int log_id);
+    bool remove_log(int do_id);
+    UILog *get_log(int doid);
+
+    /**
+     * @brief adds a file browser which lets the user pick a file starting from the given directory
+     *
+     * the file browser is laid out as described by FileBrowser and made up of regular elements, its files are shown in
+     * a scroll list, clicking a directory goes into it and clicking a file selects it. Directories are listed in the
+     * background and show up as they're listed, see UIDirectoryListingCache.
+     *
+     * @param on_open called with the path of the selected file when the open button is pressed
+     * @param on_close called when the close button is pressed, it's up to you to remove the file browser, but not
+     * from within on_close as that would remove the button that is being pressed
+     * @param visible_row_count how many files are shown at once
+     *
+     * @note the file browser is driven by the callbacks of its elements, so it only works with
+     * UIEventDispatch::callbacks
+     *
+     * @return the id of the file browser
+     */
+    int add_file_browser(std::function<void(const std::string &)> on_open, std::function<void()> on_close,
+                         const std::string &directory, float width, float height, const glm::vec3 &regular_color,
+                         const glm::vec3 &hover_color, int visible_row_count = 16);
+    bool remove_file_browser(int do_id);
+    FileBrowser *get_file_browser(int doid);
+
+    /// @brief shows the given directory in the file browser, the selected file is cleared, if the directory can't be
+    /// made absolute a warning is logged and the file browser stays where it was
+    void set_file_browser_directory(int file_browser_id, const std::string &directory);
+
+    /**
+     * @brief brings the files shown by every file browser up to date with what has been listed in the background
+     * @note process_and_queue_render_ui calls this every frame
+     */
+    void update_file_browsers();
+
+    UIDirectoryListingCache &get_directory_listing_cache() { return directory_listing_cache; }
+
+    /**
+     * @brief adds a top level container, it occupies the given rectangle and lays out whatever is added to it
+     * @return the id of the container, containers and elements share ids so this can't collide with an element
+     */
+    int add_container(const vertex_geometry::Rectangle &rect, const UILayoutParameters &parameters = {});
+    /// @brief adds a container within another container, its rectangle is decided by the layout of its parent
+    int add_child_container(int parent_container_id, const UILayoutParameters &parameters = {}, float weight = 1);
+
+    /**
+     * @brief makes an element (or container) a child of the container, it gets moved wherever the layout puts it
+     *
+     * an element can only be in one container at a time, it's taken out of the one it was in. Removing an element
+     * also takes it out of its container.
+     *
+     * @throws std::invalid_argument if a container would end up inside of itself or the element is a file browser,
+     * which is made up of elements laid out by itself, put its parts into containers instead
+     */
+    void add_to_container(int container_id, int element_id, float weight = 1);
+    /// @return whether the element was in the container, it stays wherever it was last put
+    bool remove_from_container(int container_id, int element_id);
+
+    /// @brief moves or resizes a top level container, only its subtree is laid out again
+    void set_container_rectangle(int container_id, const vertex_geometry::Rectangle &rect);
+    void set_container_layout(int container_id, const UILayoutParameters &parameters);
+
+    /// @brief removes only the container, its children stay where they are and child containers become top level
+    bool remove_container(int do_id);
+    UIContainer *get_container(int doid);
+
+    /**
+     * @brief lays out every container that is dirty
+     * @note process_and_queue_render_ui calls this every frame before processing input
+     */
+    void update_layout();
+
+    /// @brief how many containers the last update_layout laid out, which shows how much a change cost
+    size_t containers_laid_out_last_update = 0;
+
+    /**
+     * @brief writes the colored rectangles, textboxes, clickable textboxes and input boxes to a UILayoutFile
+     *
+     * elements are stored in the order they were added, names maps element ids to the names that UI::load_layout
+     * returns, elements without one are stored unnamed.
+     *
+     * @throws std::runtime_error if the file can't be written
+     */
+    void save_layout(const std::string &path, const std::unordered_map<int, std::string> &names = {});
+
+    /**
+     * @brief adds every element of the layout file using the text geometry stored in it
+     *
+     * callbacks can't be stored so clickable textboxes and input boxes are added without any, either set them on the
+     * element through the returned ids or use UIEventDispatch::event_queue.
+     *
+     * @return the ids of the named elements by name
+     */
+    std::unordered_map<std::string, int> load_layout(const UILayoutFile &layout_file);
+
+    /**
+     * @brief adds the elements described by the text form of a layout, which is how layouts are authored
+     *
+     * every line that isn't empty or a comment (starting with #) is an element, the kind followed by its name, its
+     * rectangle (center x, center y, width, height), one or two rgb colors and then its quoted text. Every line is
+     * parsed before any element is added, so when this throws nothing was added:
+     *
+     *     rectangle background 0 0 2 2 0.1 0.1 0.1
+     *     textbox title 0 0.8 1 0.2 0 0 0 "Main Menu"
+     *     clickable_textbox play 0 0.2 0.6 0.15 0.3 0.3 0.3 0.5 0.5 0.5 "Play"
+     *     input_box player_name 0 -0.2 0.6 0.15 0.3 0.3 0.3 0.5 0.5 0.5 "your name"
+     *
+     * @return the ids of the elements by name
+     * @throws std::invalid_argument naming the line if a line can't be parsed
+     */
+    std::unordered_map<std::string, int> add_layout_text(const std::string &layout_text);
+
     /*const std::vector<UIRect> &get_rectangles() const;*/
     /*const std::vector<UIClickableTextBox> &get_clickable_text_boxes() const;*/
     /*const std::vector<IVPTextured> &get_text_boxes() const;*/
@@ -329,28 +1783,288 @@ class UI {
     std::vector<UIInputBox> &get_input_boxes();
     std::vector<UITextBox> &get_text_boxes();
     std::vector<UIRect> &get_colored_boxes();
+    std::vector<UIScrollList> &get_scroll_lists();
+    std::vector<UILog> &get_logs();
+
+    /**
+     * @brief everything that was modified since the last call to clear_buffer_modifications
+     *
+     * this lets a renderer upload only what changed, for example only the colors of a button that just got hovered
+     * instead of all of its data.
+     */
+    const std::vector<UIBufferModification> &get_buffer_modifications() const;
+    void clear_buffer_modifications();
+    size_t get_buffer_modification_byte_count() const { return modified_buffers.get_modified_byte_count(); }
+
+    /// @brief how much text geometry this ui had to generate since it wasn't cached, other uis don't count
+    size_t get_text_geometry_generation_count() const { return text_geometry_generation_count; }
+
+    /**
+     * @brief everything that is visible in the ui sorted back to front, ties keep the order in which the kinds of
+     * elements have always been drawn and then the order they were added in
+     *
+     * @note colored rectangles are drawn on the ui's background layer unless their z puts them further back
+     *
+     * @note the list is only rebuilt when something is added, removed, hidden, unhidden or moves to another layer, or
+     * when a dropdown opens or closes.
+     */
+    const std::vector<UIDrawItem> &get_render_list();
+
+    /**
+     * @brief whether anything would be drawn differently than it was last frame, that is either the render list was
+     * rebuilt or some buffer was modified
+     */
+    bool has_changed_since_last_frame() const { return render_list_changed or not modified_buffers.empty(); }
+
+    /**
+     * @brief called once the ui has been drawn, resets what has_changed_since_last_frame looks at
+     */
+    void finish_frame();
+    /// @return how many times finish_frame has been called, plus one
+    uint64_t get_frame_number() const { return frame_number; }
+
+    /**
+     * @brief the background of every item of the render list as a quad instance, in the same order
+     *
+     * this is an alternative to drawing the background drawing data of each element, only rebuilt when the render list
+     * changes or a background changes color or shape.
+     */
+    const std::vector<UIQuadInstance> &get_background_quads();
+
+    /// @brief when true process_and_queue_render_ui publishes a render snapshot after processing input
+    bool publish_render_snapshots = false;
+
+    /**
+     * @brief copies the current state of the ui into a snapshot that a render thread can then acquire
+     *
+     * snapshots are triple buffered, so publishing never waits on the render thread and the render thread never waits
+     * on publishing. Only drawing data that was modified since the snapshot being filled last copied it is copied.
+     *
+     * @note only call this from the thread which processes input, and before finish_frame
+     */
+    void publish_render_snapshot();
+
+    /**
+     * @brief the most recently published snapshot, it stays valid and unchanged until the next call to this
+     * @note only call this from a single render thread
+     */
+    const UIRenderSnapshot &acquire_render_snapshot();
 
   private:
+    template <typename T> UIElementStore<T> &get_store();
+
     void disable_focus_on_all_input_boxes();
 
+    const vertex_geometry::Rectangle &get_entry_rectangle(const UISpatialEntry &entry);
+    const glm::vec3 &get_entry_background_color(const UISpatialEntry &entry);
+    bool is_entry_hovered(const UISpatialEntry &entry);
+    void set_entry_hovered(const UISpatialEntry &entry, bool hovered);
+    void set_dropdown_open(UIDropdown &dropdown, bool open);
+
+    bool uses_per_vertex_colors() const { return color_mode == UIColorMode::per_vertex; }
+    /// @return the colors for newly created drawing data, empty when using UIColorMode::uniform
+    std::vector<glm::vec3> generate_vertex_colors(size_t vertex_count, const glm::vec3 &color) const;
+    /**
+     * @brief changes the color of the background of an element, in place
+     * @param background_color the background_color member of the element which owns ivpsc
+     */
+    void set_background_color(draw_info::IVPColor &ivpsc, glm::vec3 &background_color, const glm::vec3 &color);
+    /// @return the attributes that change when the geometry of text changes
+    uint8_t get_text_geometry_attributes() const;
+
+    void layout_input_box_contents(UIInputBox &ib);
+    void show_input_box_placeholder(UIInputBox &ib);
+    void write_wrapped_input_box_contents(UIInputBox &ib, bool reuse_geometry);
+    void translate_input_box_glyph(UIInputBox &ib, size_t glyph, float x_offset);
+    void insert_input_box_glyph(UIInputBox &ib, size_t glyph, char character);
+    void erase_input_box_glyph(UIInputBox &ib, size_t glyph);
+    void insert_input_box_character(UIInputBox &ib, size_t position, char character);
+    void erase_input_box_character(UIInputBox &ib, size_t position);
+
+    /**
+     * @brief shows the item that now belongs in the row, hiding the row if there is none
+     */
+    void update_scroll_list_row(UIScrollList &sl, size_t row);
+    /**
+     * @brief called when the rows of the scroll list start showing other items, makes the next process_mouse_position
+     * hover the row under the mouse again so that its hover state and on_hover follow the item it now shows
+     */
+    void mark_hovered_scroll_list_row_changed(UIScrollList &sl);
+    /**
+     * @brief moves the text geometry of the source row into the destination row instead of generating it again,
+     * the old geometry of the destination ends up in the source row which then has to be updated or recycled itself
+     */
+    void recycle_scroll_list_row(UIScrollList &sl, size_t destination_row, size_t source_row);
+
+    struct ElementReference {
+        UIElementKind kind;
+        vertex_geometry::Rectangle *rect;
+        bool *hidden;
+    };
+    /// @brief finds the element with the id whatever kind it is, scroll lists are referred to as scroll_list_row
+    std::optional<ElementReference> find_element(int element_id);
+    /// @return the container the element or container is in, -1 if it's in none
+    int container_of(int element_id) const;
+    bool should_be_shown(int element_id);
+    /// @brief shows or hides the element depending on should_be_shown
+    void refresh_visibility(int element_id);
+    /// @brief refreshes the visibility of the element, or of everything inside of it if it's a container
+    void refresh_visibility_of_subtree(int element_id);
+
+    /// @brief lays out the children of the container, recursing into child containers that got a new rectangle
+    void layout_container(UIContainer &container);
+    std::vector<vertex_geometry::Rectangle> compute_layout(const UIContainer &container) const;
+    void mark_layout_dirty(UIContainer &container);
+    /// @brief moves and resizes any kind of element so that it occupies the rectangle, its z is kept
+    void place_element(int element_id, const vertex_geometry::Rectangle &rect);
+    void detach_from_container(int element_id);
+    /// @brief hands the id of a removed element back, which takes the element out of its container
+    void reclaim_element_id(int element_id);
+
+    /// @brief makes the file view show everything listed in the current directory so far
+    void sync_file_browser(FileBrowser &fb);
+    /// @brief goes into the entry if it's a directory, otherwise selects it
+    void select_file_browser_entry(int file_browser_id, size_t entry_index);
+
+    /**
+     * @brief fills hit_entries with everything under the point, ordered by hit priority
+     */
+    void collect_entries_under_point(const glm::vec2 &point);
+
+    /**
+     * @brief registers an element (and for dropdowns all of its options) with the hit-test table and spatial grid
+     */
+    void register_for_hit_testing(UIElementKind kind, int id);
+    void unregister_from_hit_testing(UIElementKind kind, int id);
+    void unregister_hit_slot(const UISpatialEntry &entry, const vertex_geometry::Rectangle &rect);
+
+    void rebuild_render_list();
+
+    /// @brief stores the frame the buffers modified this frame were modified in with every snapshot's copy of them
+    void record_buffer_modification_frames();
+    UISnapshotElement make_snapshot_element(const UIDrawItem &item, draw_info::IVPColor *&background_ivpsc,
+                                            draw_info::IVPColor *&text_ivpsc);
+
+    // NOTE: the second half of adding an element, once the ids have been handed out and the text geometry generated
+    void insert_textbox(int element_id, int rect_id, int text_data_id, const vertex_geometry::Rectangle &bounding_rect,
+                        const draw_info::IndexedVertexPositions &text_ivp, UITextLayout text_layout,
+                        const glm::vec3 &normalized_rgb);
+    void insert_clickable_textbox(int element_id, int rect_id, int text_data_id, std::function<void()> on_click,
+                                  std::function<void()> on_hover, const vertex_geometry::Rectangle &rect,
+                                  const draw_info::IndexedVertexPositions &text_ivp, UITextLayout text_layout,
+                                  const glm::vec3 &regular_color, const glm::vec3 &hover_color);
+    /**
+     * @brief lays the text out into the drawing data re-using the lines that didn't change, and marks what changed
+     */
+    void write_text_layout(UITextLayout &layout, std::string text, const vertex_geometry::Rectangle &rect,
+                           draw_info::IVPColor &ivpsc, bool reuse_geometry = true);
+    /// @brief lays the text out again from scratch, for when the way it's wrapped or its rectangle changed
+    void redo_text_layout(UITextLayout &layout, const vertex_geometry::Rectangle &rect, draw_info::IVPColor &ivpsc);
+    void insert_input_box(int element_id, int rect_id, int text_data_id,
+                          std::function<void(const std::string &)> on_confirm, const std::string &placeholder_text,
+                          const vertex_geometry::Rectangle &rect, const draw_info::IndexedVertexPositions &text_ivp,
+                          UITextLayout placeholder_layout, const glm::vec3 &regular_color,
+                          const glm::vec3 &focused_color, std::optional<std::string> initial_ignore_character);
+
+    /// @return true if the event was queued, in which case the element's callback must not be called
+    bool queue_event(UIEventType type, UIElementKind kind, int id, int option_index = -1, std::string_view text = {});
+    void rebuild_background_quads();
+
+    UIModifiedBuffers modified_buffers;
+    // NOTE: passed to the TextGeometryCache wherever we write text, so that only the text we generated is counted
+    size_t text_geometry_generation_count = 0;
+    UIEventQueue event_queue;
+
+    UICommandQueue command_queue;
+    // NOTE: scratch space of apply_queued_commands, the drained batch newest first and the order it gets applied in
+    std::vector<UICommand> command_batch;
+    std::vector<uint32_t> command_batch_order;
+
+    std::vector<UIDrawItem> render_list;
+    bool render_list_dirty = true;
+    bool render_list_changed = true;
+
+    std::vector<UIQuadInstance> background_quads;
+    bool background_quads_dirty = true;
+
+    uint64_t frame_number = 1;
+    std::array<UIRenderSnapshot, 3> render_snapshots;
+    // NOTE: the snapshot being written is only touched by the logic thread and the one being read only by the render
+    // thread, the third is the latest one published, the flag bit is set when it hasn't been acquired yet
+    static constexpr int snapshot_index_mask = 0b011, new_snapshot_flag = 0b100;
+    int written_snapshot_index = 0;
+    std::atomic<int> latest_snapshot_index{1};
+    int read_snapshot_index = 2;
+
+    UIHitTestTable hit_test_table;
+    UISpatialGrid spatial_grid;
+    // NOTE: everything that currently has its hover flag set, this lets us un-hover without looking at every element
+    std::vector<UISpatialEntry> hovered_entries;
+    // NOTE: scratch space for collect_entries_under_point, kept around so that we don't allocate on every query
+    std::vector<UISpatialEntry> hit_entries;
+    std::vector<int> focused_input_box_ids;
+    std::vector<int> open_dropdown_ids;
+
     std::vector<draw_info::IVPTextured> drawable_text_information;
 
-    // NOTE: these are used for checking mouse clicks
-    std::vector<UIRect> rectangles;
-    std::vector<UIDropdown> dropdowns;
-    std::vector<UIClickableTextBox> clickable_text_boxes;
-    std::vector<UITextBox> text_boxes;
-    std::vector<UIInputBox> input_boxes;
+    // NOTE: these are keyed by the ids handed out by ui_id_generator
+    UIElementStore<UIRect> rectangles;
+    UIElementStore<UIDropdown> dropdowns;
+    UIElementStore<UIClickableTextBox> clickable_text_boxes;
+    UIElementStore<UITextBox> text_boxes;
+    UIElementStore<UIInputBox> input_boxes;
+    UIElementStore<UIScrollList> scroll_lists;
+    UIElementStore<UILog> logs;
+    UIElementStore<FileBrowser> file_browsers;
+    UIElementStore<UIContainer> containers;
+    // NOTE: indexed by id, the container an element or container is in, -1 if it's in none
+    std::vector<int> container_of_element;
+    std::vector<int> dirty_container_ids;
+    // NOTE: indexed by id, whether the element is registered for hit-testing and part of the render list
+    std::vector<uint8_t> element_shown;
+
+    UIDirectoryListingCache directory_listing_cache;
 };
 
+template <> inline UIElementStore<UIRect> &UI::get_store<UIRect>() { return rectangles; }
+template <> inline UIElementStore<UITextBox> &UI::get_store<UITextBox>() { return text_boxes; }
+template <> inline UIElementStore<UIClickableTextBox> &UI::get_store<UIClickableTextBox>() {
+    return clickable_text_boxes;
+}
+template <> inline UIElementStore<UIInputBox> &UI::get_store<UIInputBox>() { return input_boxes; }
+template <> inline UIElementStore<UIDropdown> &UI::get_store<UIDropdown>() { return dropdowns; }
+template <> inline UIElementStore<UIScrollList> &UI::get_store<UIScrollList>() { return scroll_lists; }
+template <> inline UIElementStore<UILog> &UI::get_store<UILog>() { return logs; }
+template <> inline UIElementStore<FileBrowser> &UI::get_store<FileBrowser>() { return file_browsers; }
+template <> inline UIElementStore<UIContainer> &UI::get_store<UIContainer>() { return containers; }
+
 /**
  * @class IUIRenderSuite
  * @brief Interface for UI rendering operations.
+ *
+ * @note when the UI uses UIColorMode::uniform the drawing data has no rgb_colors, draw it with the background_color and
+ * text_color of the element instead.
+ *
+ * @note the rows of a UIScrollList are UITextBoxes and are drawn with render_text_box.
+ *
+ * @note the text of every line of a UILog is where its bottom row is, draw it moved by UILog::get_line_offset, see
+ * render_log.
  */
 class IUIRenderSuite {
   public:
     virtual ~IUIRenderSuite() = default;
 
+    /**
+     * @brief renders the whole ui in a single call
+     *
+     * the default draws each item with the functions below every frame. Overriding this is how a renderer gets the
+     * fast path for frames where nothing changed, one which keeps its own state (for example a recorded batch) can
+     * re-use that state as long as changed_since_last_frame is false.
+     *
+     * @param render_list the ui's render list, sorted back to front
+     */
+    virtual void render_ui(UI &ui, const std::vector<UIDrawItem> &render_list, bool changed_since_last_frame);
+
     /**
      * @brief Render a colored box.
      * @param cb The UIRect containing rendering data.
@@ -382,6 +2096,44 @@ class IUIRenderSuite {
     virtual void render_dropdown(UIDropdown &dd) = 0;
 
     virtual void render_dropdown_option(UIDropdownOption &udo) = 0;
+
+    /**
+     * @brief Render a log, its background and the text of every used slot moved by its line offset.
+     * @param log The UILog containing text and background data.
+     *
+     * @note opt-in, by default logs aren't drawn. The text of a line only ends up in its row once moved by its line
+     * offset, which none of the functions above can express, so suites written before logs existed keep compiling and
+     * override this once they can draw text at an offset.
+     */
+    virtual void render_log(UILog & /*log*/) {}
+
+    /**
+     * @brief called once per frame before anything is rendered with every buffer that was modified that frame
+     *
+     * render suites that can do partial uploads can remember these and only upload the modified ranges when the element
+     * owning the buffer is rendered, by default nothing happens and it's up to buffer_modification_tracker.
+     */
+    virtual void process_buffer_modifications(const std::vector<UIBufferModification> & /*modifications*/) {}
+};
+
+/**
+ * @brief a render suite that draws nothing
+ *
+ * useful for running a ui headless, for example when measuring how long processing a frame takes without a renderer
+ * getting in the way, it still goes through the whole render list so that the dispatch is part of what's measured.
+ */
+class NullUIRenderSuite : public IUIRenderSuite {
+  public:
+    void render_colored_box(UIRect &) override { rendered_count++; }
+    void render_text_box(UITextBox &) override { rendered_count++; }
+    void render_clickable_text_box(UIClickableTextBox &) override { rendered_count++; }
+    void render_input_box(UIInputBox &) override { rendered_count++; }
+    void render_dropdown(UIDropdown &) override { rendered_count++; }
+    void render_dropdown_option(UIDropdownOption &) override { rendered_count++; }
+    void render_log(UILog &) override { rendered_count++; }
+
+    /// @brief how many elements were "rendered" so far, which also keeps the calls from being optimized away
+    size_t rendered_count = 0;
 };
 
 /**
@@ -392,6 +2144,12 @@ class IUIRenderSuite {
 void process_and_queue_render_ui(glm::vec2 ndc_mouse_pos, UI &curr_ui, IUIRenderSuite &ui_render_suite,
                                  const std::vector<std::string> &key_strings_just_pressed,
                                  bool delete_action_just_pressed, bool confirm_action_just_pressed,
-                                 bool mouse_just_clicked);
+                                 bool mouse_just_clicked, float mouse_scroll_amount = 0);
+
+/**
+ * @brief turns the text form of a layout (see UI::add_layout_text) into a UILayoutFile at path
+ * @note this generates all of the text geometry, which is exactly the work loading the layout file later skips
+ */
+void compile_ui_layout(const std::string &layout_text, const std::string &path);
 
 #endif // UI_HPP